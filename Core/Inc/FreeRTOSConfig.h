@@ -58,17 +58,17 @@
 
 #define configUSE_PREEMPTION                     1
 #define configSUPPORT_STATIC_ALLOCATION          1
-#define configSUPPORT_DYNAMIC_ALLOCATION         1
+#define configSUPPORT_DYNAMIC_ALLOCATION         0
 #define configUSE_IDLE_HOOK                      0
 #define configUSE_TICK_HOOK                      0
 #define configCPU_CLOCK_HZ                       ( SystemCoreClock )
 #define configTICK_RATE_HZ                       ((TickType_t)1000)
 #define configMAX_PRIORITIES                     ( 56 )
 #define configMINIMAL_STACK_SIZE                 ((uint16_t)128)
-#define configTOTAL_HEAP_SIZE                    ((size_t)4096)
 #define configMAX_TASK_NAME_LEN                  ( 16 )
 #define configUSE_TRACE_FACILITY                 1
 #define configUSE_16_BIT_TICKS                   0
+#define configUSE_TICKLESS_IDLE                  2
 #define configUSE_MUTEXES                        1
 #define configQUEUE_REGISTRY_SIZE                8
 #define configUSE_RECURSIVE_MUTEXES              1
@@ -105,7 +105,7 @@ to exclude the API function. */
  * The CMSIS-RTOS V2 FreeRTOS wrapper is dependent on the heap implementation used
  * by the application thus the correct define need to be enabled below
  */
-#define USE_FreeRTOS_HEAP_4
+/* No heap implementation is linked, every kernel object is statically allocated */
 
 /* Cortex-M specific definitions. */
 #ifdef __NVIC_PRIO_BITS
@@ -151,10 +151,10 @@ standard names. */
 /* Section where parameter definitions can be added (for instance, to override default ones in FreeRTOS.h) */
 #define configRECORD_STACK_HIGH_ADDRESS 1
 #define configGENERATE_RUN_TIME_STATS 1
-extern TIM_HandleTypeDef htim3;
-extern volatile uint32_t g_HighFrequencyTimerTicks;
-#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS() HAL_TIM_Base_Start_IT(&htim3)
-#define portGET_RUN_TIME_COUNTER_VALUE()         ((g_HighFrequencyTimerTicks << 16UL) | htim3.Instance->CNT)
+/* Run-time stats in microseconds, TIM3 at 1 MHz extended by its update interrupt */
+#include "timestamp.h"
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS() Timestamp_Init()
+#define portGET_RUN_TIME_COUNTER_VALUE()         Timestamp_Micros()
 /* USER CODE END Defines */
 
 #endif /* FREERTOS_CONFIG_H */
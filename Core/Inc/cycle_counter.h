@@ -0,0 +1,35 @@
+#ifndef CYCLE_COUNTER_H
+#define CYCLE_COUNTER_H
+
+#include <stdint.h>
+
+#include "stm32f1xx.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Unit of CycleCounter_Read(), for reports
+#define CYCLE_COUNTER_UNIT "cycles"
+
+/**
+ * @brief  Enable the DWT cycle counter of the Cortex-M3 core.
+ * @retval None
+ */
+static inline void CycleCounter_Init(void) {
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/**
+ * @brief  Read the cycle counter, wraps after 2^32 cycles (~60 s at 72 MHz).
+ * @retval Current cycle count
+ */
+static inline uint32_t CycleCounter_Read(void) { return DWT->CYCCNT; }
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // CYCLE_COUNTER_H
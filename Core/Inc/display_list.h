@@ -0,0 +1,188 @@
+#ifndef DISPLAY_LIST_H
+#define DISPLAY_LIST_H
+
+#include <stdint.h>
+
+#include "u8g2.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Frame recorded as draw commands, rendered page by page.
+ *
+ * In page buffer mode u8g2 holds only a window of the display (one page of 8
+ * rows with a *_1 setup, 128 bytes instead of 1 KB) and the frame is drawn
+ * once per window. A display list records the frame once instead: every
+ * command is a draw function with its arguments and the bounding box of the
+ * pixels it sets. Rendering replays, for each window, only the commands whose
+ * box touches it.
+ *
+ * The commands of a window also tell whether it changed since the last frame:
+ * DisplayList_Render() keeps a hash of them per window and skips the windows
+ * with the same commands as before. Of a changed window only the tile columns
+ * covered by the boxes of this frame and of the last one are sent. The bytes
+ * sent and skipped are counted for the last frame and in total.
+ *
+ * By default a window is sent with u8x8_DrawTile(), which returns once the
+ * tiles are on the display, so a frame takes the time to render plus the time
+ * to send its windows. With a transport that sends without waiting (DMA), the
+ * windows are rendered into two page buffers in turns: one is rasterized while
+ * the other one is still being sent, and a frame takes about max(render,
+ * transfer). The task only waits for the transport when it is a window ahead;
+ * waiting less would take more page buffers, a frame of them is the full
+ * buffer page mode saves.
+ *
+ * A command must draw the same pixels for the same arguments, draw functions
+ * that read other state (e.g. a text overlay) put a revision of it into param.
+ * Commands draw in the current draw color on a cleared window.
+ */
+
+#define DISPLAY_LIST_PAGES 8  // windows whose hash is kept, the others are always sent
+
+typedef struct DisplayCommand DisplayCommand_t;
+typedef void (*DisplayDrawFn)(u8g2_t* u8g2, const DisplayCommand_t* command);
+
+struct DisplayCommand {
+  DisplayDrawFn draw;
+  const void* data;  // for the draw function
+  int16_t x;         // bounding box of the pixels drawn
+  int16_t y;
+  uint8_t w;
+  uint8_t h;
+  uint16_t param;    // for the draw function
+};
+
+/**
+ * Sends rows of tiles without waiting for them. The tiles must stay as they
+ * are until the fence returned for them has been reached.
+ */
+typedef struct {
+  uint32_t (*send)(u8g2_t* u8g2, uint8_t tx, uint8_t ty, uint8_t tw, const uint8_t* tiles);
+  uint8_t (*wait)(uint32_t fence);  // 0 if the tiles may not have reached the display
+} DisplayTransport_t;
+
+typedef struct {
+  DisplayCommand_t* commands;
+  uint8_t capacity;
+  uint8_t count;
+  uint8_t dropped;   // commands that did not fit into this frame
+  uint8_t is_valid;  // the display shows what the hashes describe
+  uint32_t page_hash[DISPLAY_LIST_PAGES];
+  uint8_t page_tx0[DISPLAY_LIST_PAGES];  // tile columns drawn in the window, from tx0 to before tx1
+  uint8_t page_tx1[DISPLAY_LIST_PAGES];
+  uint16_t frame_bytes_sent;  // statistics of the last DisplayList_Render()
+  uint16_t frame_bytes_skipped;
+  uint32_t total_bytes_sent;  // since DisplayList_Init(), wraps around
+  uint32_t total_bytes_skipped;
+  const DisplayTransport_t* transport;  // NULL: sent with u8x8_DrawTile()
+  uint8_t* buffers[2];                  // rendered in turns, the first one is the buffer of u8g2
+  uint32_t fences[2];                   // of the tiles sent from each buffer
+  uint8_t is_sending[2];
+  uint8_t buffer;                       // the next one to render into
+} DisplayList_t;
+
+#define DisplayList_GetFrameBytesSent(list) ((list)->frame_bytes_sent)
+#define DisplayList_GetFrameBytesSkipped(list) ((list)->frame_bytes_skipped)
+
+/**
+ * @brief  Set up an empty list, the first render sends every window.
+ * @param  list: list instance
+ * @param  commands: storage for the commands of one frame
+ * @param  capacity: number of commands
+ * @retval None
+ */
+void DisplayList_Init(DisplayList_t* list, DisplayCommand_t* commands, uint8_t capacity);
+
+/**
+ * @brief  Send the windows through a transport, from the buffer of u8g2 and a second one in turns.
+ * @param  list: list instance
+ * @param  u8g2: u8g2 instance the list is rendered with
+ * @param  transport: transport, must stay valid
+ * @param  buffer: second buffer of u8g2_GetBufferSize() bytes
+ * @retval None
+ */
+void DisplayList_SetTransport(DisplayList_t* list, u8g2_t* u8g2, const DisplayTransport_t* transport,
+                              uint8_t* buffer);
+
+/**
+ * @brief  Wait until the transport has sent the buffers, before u8g2 draws outside of the list.
+ * @param  list: list instance
+ * @param  u8g2: u8g2 instance the list is rendered with
+ * @retval None
+ */
+void DisplayList_Sync(DisplayList_t* list, u8g2_t* u8g2);
+
+/**
+ * @brief  Drop the recorded commands to record a new frame.
+ * @param  list: list instance
+ * @retval None
+ */
+void DisplayList_Clear(DisplayList_t* list);
+
+/**
+ * @brief  Forget what the display shows, the next render sends every window.
+ * @param  list: list instance
+ * @retval None
+ */
+void DisplayList_Invalidate(DisplayList_t* list);
+
+/**
+ * @brief  Record a command.
+ * @param  list: list instance
+ * @param  draw: draws the command, called with the u8g2 instance and the command
+ * @param  data: for the draw function
+ * @param  x, y, w, h: bounding box of the pixels the command may set
+ * @param  param: for the draw function
+ * @retval 1 if recorded, 0 if the list is full
+ */
+uint8_t DisplayList_Add(DisplayList_t* list, DisplayDrawFn draw, const void* data, int16_t x, int16_t y, uint8_t w,
+                        uint8_t h, uint16_t param);
+
+/**
+ * @brief  Record u8g2_DrawBox(u8g2, x, y, w, h).
+ * @retval 1 if recorded, 0 if the list is full
+ */
+uint8_t DisplayList_Box(DisplayList_t* list, int16_t x, int16_t y, uint8_t w, uint8_t h);
+
+/**
+ * @brief  Record u8g2_DrawRBox(u8g2, x, y, w, h, r).
+ * @retval 1 if recorded, 0 if the list is full
+ */
+uint8_t DisplayList_RBox(DisplayList_t* list, int16_t x, int16_t y, uint8_t w, uint8_t h, uint8_t r);
+
+/**
+ * @brief  Record u8g2_DrawDisc(u8g2, x, y, r, option).
+ * @retval 1 if recorded, 0 if the list is full
+ */
+uint8_t DisplayList_Disc(DisplayList_t* list, int16_t x, int16_t y, uint8_t r, uint8_t option);
+
+/**
+ * @brief  Record u8g2_DrawHLine(u8g2, x, y, w).
+ * @retval 1 if recorded, 0 if the list is full
+ */
+uint8_t DisplayList_HLine(DisplayList_t* list, int16_t x, int16_t y, uint8_t w);
+
+/**
+ * @brief  Draw the commands that touch the window of the buffer.
+ * @param  list: list instance
+ * @param  u8g2: u8g2 instance, page or full buffer, the buffer is not cleared
+ * @retval None
+ */
+void DisplayList_Replay(const DisplayList_t* list, u8g2_t* u8g2);
+
+/**
+ * @brief  Render the recorded frame window by window and send the changed ones.
+ * @note   With a transport the last windows may still be sent on return, see DisplayList_Sync().
+ * @param  list: list instance
+ * @param  u8g2: u8g2 instance, page or full buffer
+ * @retval Number of windows sent
+ */
+uint8_t DisplayList_Render(DisplayList_t* list, u8g2_t* u8g2);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // DISPLAY_LIST_H
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @brief Compile-time easing curves with fixed-point interpolation.
+ *
+ * A curve is a type with a constexpr eval(t) mapping 0..1 to its eased value
+ * (0 at the start, 1 at the end, in between it may overshoot). Its table of
+ * N + 1 samples is generated by the compiler and placed in flash, lookups
+ * interpolate linearly between two samples in Q8. Values are Q14, EASING_ONE
+ * stands for 1.0.
+ *
+ * Curves are selected with a template parameter:
+ *
+ *   int h = easing::lerpFor<easing::SineOut, BLINK_DURATION_MS>(0, EYE_HEIGHT, elapsed);
+ *
+ * With the duration as template parameter the position is computed with a
+ * division by a constant, which the compiler turns into a multiplication.
+ */
+
+#define EASING_ONE (1 << 14)
+#define EASING_RESOLUTION 32
+
+namespace easing {
+
+// --- constexpr math, std::sin and std::exp are not constexpr ---
+namespace detail {
+
+constexpr double kPi = 3.14159265358979323846;
+
+constexpr double sin(double x) {
+  while (x > kPi) x -= 2 * kPi;
+  while (x < -kPi) x += 2 * kPi;
+  double term = x;
+  double sum = x;
+  for (int n = 1; n < 12; n++) {
+    term *= -x * x / ((2 * n) * (2 * n + 1));
+    sum += term;
+  }
+  return sum;
+}
+
+constexpr double cos(double x) { return sin(x + kPi / 2); }
+
+constexpr double exp(double x) {
+  bool negative = x < 0;
+  if (negative) x = -x;
+  double term = 1;
+  double sum = 1;
+  for (int n = 1; n < 40; n++) {
+    term *= x / n;
+    sum += term;
+  }
+  return negative ? 1 / sum : sum;
+}
+
+}  // namespace detail
+
+// --- Curves ---
+struct Linear {
+  static constexpr double eval(double t) { return t; }
+};
+
+struct SineIn {
+  static constexpr double eval(double t) { return 1 - detail::cos(t * detail::kPi / 2); }
+};
+
+struct SineOut {
+  static constexpr double eval(double t) { return detail::sin(t * detail::kPi / 2); }
+};
+
+struct SineInOut {
+  static constexpr double eval(double t) { return (1 - detail::cos(t * detail::kPi)) / 2; }
+};
+
+struct CubicIn {
+  static constexpr double eval(double t) { return t * t * t; }
+};
+
+struct CubicOut {
+  static constexpr double eval(double t) { return 1 - (1 - t) * (1 - t) * (1 - t); }
+};
+
+struct CubicInOut {
+  static constexpr double eval(double t) {
+    return t < 0.5 ? 4 * t * t * t : 1 - (2 - 2 * t) * (2 - 2 * t) * (2 - 2 * t) / 2;
+  }
+};
+
+// Damped oscillation around the end value, overshoots by about 30%
+struct Spring {
+  static constexpr double eval(double t) { return 1 - detail::exp(-6 * t) * detail::cos(5 * detail::kPi * t); }
+};
+
+// Bounces on the end value like a dropped ball
+struct Bounce {
+  static constexpr double eval(double t) {
+    constexpr double n1 = 7.5625;
+    constexpr double d1 = 2.75;
+    if (t < 1 / d1) return n1 * t * t;
+    if (t < 2 / d1) {
+      t -= 1.5 / d1;
+      return n1 * t * t + 0.75;
+    }
+    if (t < 2.5 / d1) {
+      t -= 2.25 / d1;
+      return n1 * t * t + 0.9375;
+    }
+    t -= 2.625 / d1;
+    return n1 * t * t + 0.984375;
+  }
+};
+
+// --- Tables ---
+template <int N>
+struct Samples {
+  int16_t v[N + 1];
+};
+
+template <class Curve, int N>
+constexpr Samples<N> makeSamples() {
+  Samples<N> s{};
+  for (int i = 0; i <= N; i++) {
+    double v = Curve::eval((double)i / N) * EASING_ONE;
+    s.v[i] = (int16_t)(v < 0 ? v - 0.5 : v + 0.5);
+  }
+  // Pin the end points, so an animation ends exactly at its target
+  s.v[0] = 0;
+  s.v[N] = EASING_ONE;
+  return s;
+}
+
+template <class Curve, int N = EASING_RESOLUTION>
+struct Table {
+  static_assert(N >= 1 && N <= 256, "easing table resolution out of range");
+  static constexpr Samples<N> samples = makeSamples<Curve, N>();
+};
+
+// --- Lookup ---
+
+// Curve value at pos, in Q8 units of table entries (0 .. N * 256)
+template <class Curve, int N = EASING_RESOLUTION>
+constexpr int32_t sample(uint32_t pos) {
+  if (pos >= (uint32_t)N * 256) return EASING_ONE;
+  const int16_t* v = Table<Curve, N>::samples.v;
+  uint32_t idx = pos >> 8;
+  int32_t frac = pos & 0xFF;
+  return v[idx] + (v[idx + 1] - v[idx]) * frac / 256;
+}
+
+// Curve value after elapsed of duration, in Q14. duration * N * 256 must fit in 32 bits.
+template <class Curve, int N = EASING_RESOLUTION>
+constexpr int32_t value(uint32_t elapsed, uint32_t duration) {
+  if (elapsed >= duration) return EASING_ONE;
+  return sample<Curve, N>(elapsed * (N * 256) / duration);
+}
+
+template <class Curve, uint32_t Duration, int N = EASING_RESOLUTION>
+constexpr int32_t valueFor(uint32_t elapsed) {
+  static_assert(Duration > 0 && Duration <= UINT32_MAX / (N * 256), "easing duration out of range");
+  if (elapsed >= Duration) return EASING_ONE;
+  return sample<Curve, N>(elapsed * (N * 256) / Duration);
+}
+
+// Interpolate from -> to along the curve
+template <class Curve, int N = EASING_RESOLUTION>
+constexpr int32_t lerp(int32_t from, int32_t to, uint32_t elapsed, uint32_t duration) {
+  return from + (to - from) * value<Curve, N>(elapsed, duration) / EASING_ONE;
+}
+
+template <class Curve, uint32_t Duration, int N = EASING_RESOLUTION>
+constexpr int32_t lerpFor(int32_t from, int32_t to, uint32_t elapsed) {
+  return from + (to - from) * valueFor<Curve, Duration, N>(elapsed) / EASING_ONE;
+}
+
+}  // namespace easing
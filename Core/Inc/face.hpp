@@ -2,12 +2,19 @@
 
 #include <cstdint>
 
+#include "display_list.h"
+#include "face_timeline.hpp"
 #include "u8g2.h"
 
 class Face;
 
 extern Face g_faceInstance;
 
+#ifdef FACE_BENCHMARK
+// Cycles to draw both eyes at every height, with u8g2_DrawRBox and with the sprite cache
+void benchmarkEyeDrawing(u8g2_t* u8g2, uint32_t* rboxCycles, uint32_t* spriteCycles);
+#endif
+
 /**
  * @brief Abstract Base Class for all face animations.
  *
@@ -20,8 +27,11 @@ class Animation {
 
   virtual void start(uint32_t currentTime) = 0;
   virtual Animation* update(uint32_t currentTime) = 0;
-  virtual void draw(u8g2_t* u8g2, uint32_t currentTime) = 0;
+  virtual void draw(DisplayList_t* list, uint32_t currentTime) = 0;
   virtual int get_offset_x(uint32_t currentTime) const = 0;
+  // Earliest time at which draw() may produce a different image, currentTime
+  // while the animation is moving
+  virtual uint32_t getNextChangeTime(uint32_t currentTime) const = 0;
 
   // Default pause/resume do nothing. Can be overridden.
   virtual void pause(uint32_t currentTime);
@@ -48,8 +58,9 @@ class NormalEyesAnimation : public Animation {
   explicit NormalEyesAnimation(Face* face);
   void start(uint32_t currentTime) override;
   Animation* update(uint32_t currentTime) override;
-  void draw(u8g2_t* u8g2, uint32_t currentTime) override;
+  void draw(DisplayList_t* list, uint32_t currentTime) override;
   int get_offset_x(uint32_t currentTime) const override;
+  uint32_t getNextChangeTime(uint32_t currentTime) const override;
 
  private:
   uint32_t m_nextLookTime = 0;
@@ -64,14 +75,14 @@ class BlinkAnimation : public Animation {
   explicit BlinkAnimation(Face* face);
   void start(uint32_t currentTime) override;
   Animation* update(uint32_t currentTime) override;
-  void draw(u8g2_t* u8g2, uint32_t currentTime) override;
+  void draw(DisplayList_t* list, uint32_t currentTime) override;
   int get_offset_x(uint32_t currentTime) const override;
+  uint32_t getNextChangeTime(uint32_t currentTime) const override;
 
   void setReturnAnimation(Animation* anim);
 
  private:
-  enum State { CLOSING, CLOSED, OPENING };
-  State m_internalState = CLOSING;
+  TimelinePlayer m_timeline;
   Animation* m_returnAnimation = nullptr;
 };
 
@@ -83,8 +94,9 @@ class LookAnimation : public Animation {
   explicit LookAnimation(Face* face);
   void start(uint32_t currentTime) override;
   Animation* update(uint32_t currentTime) override;
-  void draw(u8g2_t* u8g2, uint32_t currentTime) override;
+  void draw(DisplayList_t* list, uint32_t currentTime) override;
   int get_offset_x(uint32_t currentTime) const override;
+  uint32_t getNextChangeTime(uint32_t currentTime) const override;
   void pause(uint32_t currentTime) override;
   void resume(uint32_t currentTime) override;
 
@@ -96,6 +108,26 @@ class LookAnimation : public Animation {
   int m_target_offset_x = 0;
 };
 
+/**
+ * @brief Plays an expression timeline, then returns to the resting eyes.
+ * One class serves every expression, an expression is only data.
+ */
+class ExpressionAnimation : public Animation {
+ public:
+  explicit ExpressionAnimation(Face* face);
+  void start(uint32_t currentTime) override;
+  Animation* update(uint32_t currentTime) override;
+  void draw(DisplayList_t* list, uint32_t currentTime) override;
+  int get_offset_x(uint32_t currentTime) const override;
+  uint32_t getNextChangeTime(uint32_t currentTime) const override;
+
+  void setTimeline(const Timeline* timeline);
+
+ private:
+  const Timeline* m_source = nullptr;
+  TimelinePlayer m_timeline;
+};
+
 /**
  * @brief The main class managing the face's state and animations.
  */
@@ -106,19 +138,36 @@ class Face {
   Face(const Face&) = delete;
   Face& operator=(const Face&) = delete;
 
+  enum class Expression : uint8_t { Wink, Squint, Nod, Count };
+
   void init();
   void update(uint32_t currentTime);
-  void draw(u8g2_t* u8g2, uint32_t currentTime);
+  // Records the eyes into the list, at most FACE_COMMANDS_MAX commands
+  void draw(DisplayList_t* list, uint32_t currentTime);
+
+  // True while an animation other than the resting eyes is running
+  bool isAnimating() const;
+  // Earliest time at which the face may look different, currentTime while moving
+  uint32_t getNextChangeTime(uint32_t currentTime) const;
+  // True if the face may look different from the last draw() call
+  bool isDirty(uint32_t currentTime) const;
+  // Play an expression from the next update(), after a running blink
+  void playExpression(Expression expression);
 
  private:
   friend class NormalEyesAnimation;
   friend class BlinkAnimation;
   friend class LookAnimation;
+  friend class ExpressionAnimation;
 
   NormalEyesAnimation m_normalEyes;
   BlinkAnimation m_blink;
   LookAnimation m_look;
+  ExpressionAnimation m_expression;
 
   Animation* m_currentAnimation;
+  const Timeline* volatile m_pendingExpression;
   uint32_t m_nextBlinkTime;
+  uint32_t m_drawnUntilTime;  // next change time at the last draw()
+  bool m_isDrawn;
 };
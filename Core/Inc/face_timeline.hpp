@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @brief Keyframe timelines for face expressions.
+ *
+ * An expression is a Timeline in flash: a list of tracks, each animating one
+ * property of the face pose through a list of keyframes. A keyframe holds a
+ * time, a value and the easing curve of the segment that leads to it; before
+ * the first keyframe a track starts from the value of the base pose, after the
+ * last one it holds the last value. Properties without a track keep the base
+ * pose value.
+ *
+ * TimelinePlayer evaluates a timeline per frame. It is a plain class, there is
+ * no virtual dispatch and no allocation, the whole state is a pointer and a
+ * start time.
+ */
+
+enum class Ease : uint8_t {
+  Step,  // hold the previous value, jump at the keyframe
+  Linear,
+  SineIn,
+  SineOut,
+  SineInOut,
+  CubicIn,
+  CubicOut,
+  CubicInOut,
+  Spring,
+  Bounce,
+};
+
+enum class TrackTarget : uint8_t {
+  LeftHeight,
+  RightHeight,
+  BothHeights,
+  OffsetX,
+  OffsetY,
+  LeftLid,
+  RightLid,
+  BothLids,
+};
+
+struct Keyframe {
+  uint16_t timeMs;  // from the start of the timeline
+  int8_t value;
+  Ease ease;  // curve from the previous keyframe to this one
+};
+
+struct TimelineTrack {
+  TrackTarget target;
+  uint8_t keyCount;
+  const Keyframe* keys;  // sorted by time
+};
+
+struct Timeline {
+  const TimelineTrack* tracks;
+  uint8_t trackCount;
+  uint16_t durationMs;
+};
+
+#define TIMELINE_TRACK(target, keys) \
+  { (target), (uint8_t)(sizeof(keys) / sizeof((keys)[0])), (keys) }
+#define TIMELINE(tracks, durationMs) \
+  { (tracks), (uint8_t)(sizeof(tracks) / sizeof((tracks)[0])), (durationMs) }
+
+// Everything a timeline can animate
+struct FacePose {
+  int16_t leftHeight;
+  int16_t rightHeight;
+  int16_t offsetX;
+  int16_t offsetY;
+  // Shape of each eye: rows hidden from its top, a flat upper lid
+  int16_t leftLid;
+  int16_t rightLid;
+};
+
+class TimelinePlayer {
+ public:
+  void start(const Timeline* timeline, uint32_t currentTime);
+
+  bool isFinished(uint32_t currentTime) const;
+  // Apply the tracks at currentTime on top of the base pose
+  FacePose evaluate(const FacePose& base, uint32_t currentTime) const;
+  // Earliest time at which evaluate() may return a different pose,
+  // currentTime while a track is moving
+  uint32_t getNextChangeTime(uint32_t currentTime) const;
+
+ private:
+  const Timeline* m_timeline = nullptr;
+  uint32_t m_startTime = 0;
+};
@@ -3,20 +3,40 @@
 
 #include <stdint.h>
 
+#include "display_list.h"
 #include "u8g2.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+// Display list commands the face records per frame, at most
+#define FACE_COMMANDS_MAX 2
+
 // Opaque pointer to hide the C++ Face object from C code
 typedef void* FaceHandle;
 
+// Same order as Face::Expression
+typedef enum {
+  FACE_EXPRESSION_WINK,
+  FACE_EXPRESSION_SQUINT,
+  FACE_EXPRESSION_NOD,
+} FaceExpression;
+
 FaceHandle Face_Create(void);
 void Face_Destroy(FaceHandle handle);
 void Face_Init(FaceHandle handle);
 void Face_Update(FaceHandle handle, uint32_t currentTime);
 void Face_Draw(FaceHandle handle, u8g2_t* u8g2, uint32_t currentTime);
+void Face_Record(FaceHandle handle, DisplayList_t* list, uint32_t currentTime);
+uint8_t Face_IsAnimating(FaceHandle handle);
+uint32_t Face_GetNextChangeTime(FaceHandle handle, uint32_t currentTime);
+uint8_t Face_IsDirty(FaceHandle handle, uint32_t currentTime);
+void Face_PlayExpression(FaceHandle handle, FaceExpression expression);
+
+#ifdef FACE_BENCHMARK
+void Face_BenchmarkEyes(u8g2_t* u8g2, uint32_t* rboxCycles, uint32_t* spriteCycles);
+#endif
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,101 @@
+#ifndef FRAME_SCHEDULER_H
+#define FRAME_SCHEDULER_H
+
+#include <stdint.h>
+
+#include "cmsis_os.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Fixed-phase frame pacing for a render task.
+ *
+ * Frame slots are placed on a grid of the kernel tick, every deadline is the
+ * previous one plus the frame period, so a slow frame does not shift the
+ * frames after it. When a frame takes longer than a period the slots it
+ * overran are reported as missed and skipped, the phase is kept.
+ *
+ * The task waits for the next slot on its thread flags (a task notification),
+ * so other tasks and interrupts can request a frame early with
+ * FrameScheduler_Wake(). Two rates are kept: the active rate while something
+ * is moving on screen and the idle rate otherwise, selected with
+ * FrameScheduler_SetActive(). A task that knows when its content changes next
+ * uses FrameScheduler_SetNextChange() instead and sleeps until then while idle.
+ */
+
+#define FRAME_SCHEDULER_WAKE_FLAG 0x0001U
+
+typedef struct {
+  osThreadId_t thread;              // render task, receives the wake flag
+  volatile uint32_t active_period;  // frame period in ticks while animating
+  volatile uint32_t idle_period;    // frame period in ticks while idle
+  uint32_t period;                  // period of the current slot
+  uint32_t deadline;                // tick of the current slot
+  uint32_t frame_count;             // frames since init
+  uint32_t missed_count;            // missed deadlines since init
+  uint32_t wake_time;               // tick of the next content change
+  uint8_t is_active;
+  uint8_t has_wake_time;
+} FrameScheduler_t;
+
+/**
+ * @brief  Initialize the scheduler for the calling task, the first slot is now.
+ * @param  sched: scheduler instance
+ * @param  active_fps: frame rate while animating
+ * @param  idle_fps: frame rate while idle
+ * @retval None
+ */
+void FrameScheduler_Init(FrameScheduler_t* sched, uint32_t active_fps, uint32_t idle_fps);
+
+/**
+ * @brief  Change the frame rates, takes effect from the next slot. May be
+ *         called from any task.
+ * @param  sched: scheduler instance
+ * @param  active_fps: frame rate while animating
+ * @param  idle_fps: frame rate while idle
+ * @retval None
+ */
+void FrameScheduler_SetRate(FrameScheduler_t* sched, uint32_t active_fps, uint32_t idle_fps);
+
+/**
+ * @brief  Select the active or idle frame rate for the following slots.
+ * @param  sched: scheduler instance
+ * @param  active: non-zero while something is moving on screen
+ * @retval None
+ */
+void FrameScheduler_SetActive(FrameScheduler_t* sched, uint8_t active);
+
+/**
+ * @brief  Tell the scheduler when the content changes next. Changes due within
+ *         one active period select the active rate, later changes make the
+ *         task sleep until that tick instead of rendering idle frames.
+ * @param  sched: scheduler instance
+ * @param  tick: kernel tick of the next change
+ * @retval None
+ */
+void FrameScheduler_SetNextChange(FrameScheduler_t* sched, uint32_t tick);
+
+/**
+ * @brief  Block until the next frame slot or until woken.
+ * @param  sched: scheduler instance
+ * @retval Number of deadlines missed since the previous frame
+ */
+uint32_t FrameScheduler_WaitNextFrame(FrameScheduler_t* sched);
+
+/**
+ * @brief  Request a frame before the next slot. Safe to call from an ISR.
+ * @param  sched: scheduler instance
+ * @retval None
+ */
+void FrameScheduler_Wake(FrameScheduler_t* sched);
+
+#define FrameScheduler_GetFrameCount(sched) ((sched)->frame_count)
+#define FrameScheduler_GetMissedCount(sched) ((sched)->missed_count)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // FRAME_SCHEDULER_H
@@ -0,0 +1,63 @@
+#ifndef LOG_H
+#define LOG_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "stm32f1xx_hal.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Non-blocking logger, drained to a UART by DMA.
+ *
+ * Messages are copied into a byte ring buffer and the call returns, the
+ * transmission runs in the background. Writers never wait: space is reserved
+ * with a compare-and-swap on the write index, so tasks and interrupts may log
+ * concurrently without locks. A message that does not fit is dropped and
+ * counted instead of blocking the caller.
+ *
+ * The ring is sent once no write is in progress. The writer that completes
+ * the last pending write or the DMA completion starts the next transfer, up
+ * to the end of the ring per transfer.
+ */
+
+#define LOG_RING_SIZE 1024  // power of two
+#define LOG_LINE_MAX 96     // longer Log_Printf lines are truncated
+
+/**
+ * @brief  Attach the UART and send what was logged before.
+ * @param  huart: UART with a TX DMA channel linked
+ * @retval None
+ */
+void Log_Init(UART_HandleTypeDef* huart);
+
+/**
+ * @brief  Queue raw bytes, all or nothing. Safe to call from an ISR.
+ * @param  data: bytes to send
+ * @param  len: number of bytes
+ * @retval 1 if queued, 0 if dropped
+ */
+uint8_t Log_Write(const void* data, size_t len);
+
+/**
+ * @brief  Format a line on the caller's stack and queue it. Safe to call from
+ *         an ISR, formatting is reentrant.
+ * @param  fmt: printf format
+ * @retval None
+ */
+void Log_Printf(const char* fmt, ...) __attribute__((format(printf, 1, 2)));
+
+/**
+ * @brief  Number of messages dropped because the ring was full.
+ * @retval Drop count since reset
+ */
+uint32_t Log_GetDropCount(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // LOG_H
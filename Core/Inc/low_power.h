@@ -0,0 +1,73 @@
+#ifndef LOW_POWER_H
+#define LOW_POWER_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Tickless idle for the FreeRTOS ARM_CM3 port.
+ *
+ * When every task is blocked the kernel calls vPortSuppressTicksAndSleep(),
+ * defined here instead of the SysTick based version of the port
+ * (configUSE_TICKLESS_IDLE 2). The SysTick and the HAL timebase (TIM4) are
+ * stopped and the core sleeps until the next task is due, woken by an RTC
+ * alarm, or earlier by any interrupt:
+ *
+ * - SLEEP: the core clock stops, the peripherals keep running. The time slept
+ *   is read from the microsecond timestamp (TIM3).
+ * - STOP: all clocks but the LSI stop and the RTC alarm on EXTI line 17 is
+ *   the only wake up source. Used for idle periods of LOW_POWER_STOP_MIN_MS
+ *   or more while no I2C, UART or capture transfer is running. On wake up the
+ *   PLL is restarted and the time slept is taken from the RTC counter, the
+ *   timestamp is moved forward to match.
+ *
+ * The kernel tick count is stepped by the time slept, the part of a tick left
+ * over is carried into the first SysTick period, so the tick does not drift
+ * against the timestamp. The HAL tick is stepped from the same microseconds,
+ * its leftover fraction stays in the TIM4 counter.
+ *
+ * The LSI is only accurate to tens of percent, its rate is measured against
+ * TIM3 while idling in SLEEP. STOP is used once the first
+ * LOW_POWER_CALIBRATION_US of SLEEP have been measured.
+ */
+
+#define LOW_POWER_STOP_MIN_MS 10        // shorter idle periods use SLEEP
+#define LOW_POWER_STOP_WAKE_US 2000     // HSE start up and PLL lock after STOP
+#define LOW_POWER_CALIBRATION_US 1000000
+
+typedef struct {
+  uint32_t sleep_count;  // low power periods entered
+  uint32_t sleep_us;     // total time in them, wraps like the timestamp
+  uint32_t stop_count;
+  uint32_t stop_us;
+  uint32_t rtc_hz;  // measured RTC counter rate, 0 before the first calibration
+} LowPowerStats_t;
+
+/**
+ * @brief  Start the LSI and the RTC alarm used to wake up, called before the
+ *         scheduler starts and after Timestamp_Init().
+ * @retval None
+ */
+void LowPower_Init(void);
+
+/**
+ * @brief  Residency counters since LowPower_Init().
+ * @param  stats: receives a copy of the counters
+ * @retval None
+ */
+void LowPower_GetStats(LowPowerStats_t* stats);
+
+/**
+ * @brief  RTC alarm interrupt, called from RTC_Alarm_IRQHandler.
+ * @retval None
+ */
+void LowPower_AlarmIRQHandler(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // LOW_POWER_H
@@ -0,0 +1,62 @@
+#ifndef MONITOR_H
+#define MONITOR_H
+
+#include <stdint.h>
+
+#include "cmsis_os.h"
+#include "display_list.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * System monitor: a low priority task that samples the FreeRTOS run-time
+ * stats every MONITOR_PERIOD_MS and logs them as JSON lines, one record per
+ * line with a "mon" type field:
+ *
+ *   {"mon":"sys","t":10000,"log_drops":0}
+ *   {"mon":"power","sleep":31.2,"sleep_n":640,"stop":55.0,"stop_n":102,"rtc_hz":10240}
+ *   {"mon":"task","name":"displayTask","prio":16,"cpu":12.4,"stack_free":412}
+ *   {"mon":"display","sent":5120,"skipped":97280}
+ *
+ * cpu is the share of the run-time counter the task used since the previous
+ * sample in percent, stack_free the smallest stack headroom since the task
+ * started in bytes. sleep and stop are the shares of the period spent in
+ * those low power modes in percent, with the number of times each was entered.
+ * sent and skipped are the bytes of the display list's frames sent to and
+ * skipped for the display during the period.
+ * A "queue" record with used and size follows for every queue added with
+ * Monitor_WatchQueue(), the firmware currently has none to watch.
+ */
+
+#define MONITOR_PERIOD_MS 5000
+#define MONITOR_MAX_TASKS 8
+#define MONITOR_MAX_QUEUES 4
+
+/**
+ * @brief  Add a message queue to the report. Call before Monitor_Init().
+ * @param  name: name in the report
+ * @param  queue: queue to report the fill level of
+ * @retval None
+ */
+void Monitor_WatchQueue(const char* name, osMessageQueueId_t queue);
+
+/**
+ * @brief  Add the bytes a display list sent and skipped to the report. Call before Monitor_Init().
+ * @param  list: display list to report, rendered by another task
+ * @retval None
+ */
+void Monitor_WatchDisplayList(const DisplayList_t* list);
+
+/**
+ * @brief  Create the monitor task.
+ * @retval None
+ */
+void Monitor_Init(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // MONITOR_H
@@ -0,0 +1,97 @@
+#ifndef PAGE_FONT_H
+#define PAGE_FONT_H
+
+#include <stdint.h>
+
+#include "u8g2.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Glyphs of a u8g2 font pre-decoded into the layout of the frame buffer.
+ *
+ * u8g2 fonts are run-length coded: every glyph drawn is decoded bit by bit
+ * and goes to the buffer as a series of short horizontal lines. A page font
+ * keeps a few glyphs of such a font (digits, units, symbols of a value that
+ * changes often) as columns of vertical bytes instead, LSB on top, one byte
+ * per page of the cell. This is how the SH1106 and the vertical_top_lsb
+ * buffer of u8g2 store pixels, so drawing a glyph is a shift and a mask per
+ * column into the one or two pages it covers.
+ *
+ * The glyphs are rasterized by u8g2 when the page font is set up, in the
+ * frame buffer, the way a text overlay is rasterized. A page font draws the
+ * same pixels as u8g2_DrawStr() with its font: set pixels in the draw color,
+ * in the solid font mode also the background of each glyph box, clipped to
+ * the clip window and the buffer window. Characters not in the page font,
+ * and draw color 2, rotated displays or other buffer layouts, are drawn by
+ * u8g2 from the font.
+ */
+
+#define PAGE_FONT_MAX_PAGES 3   // a column of the cell is shifted within 32 bits
+#define PAGE_FONT_MAX_WIDTH 32  // columns rasterized per glyph
+
+typedef struct {
+  uint16_t offset;  // first byte of the glyph in the bitmap
+  int8_t x;         // left column of the glyph box, from the cursor
+  int8_t advance;   // from this cursor to the next
+  uint8_t width;    // columns of the glyph box, pages bytes each
+  uint8_t top;      // first row of the glyph box in the cell
+  uint8_t height;   // rows of the glyph box
+} PageGlyph_t;
+
+typedef struct {
+  const uint8_t* font;   // u8g2 font of the glyphs, draws the other characters
+  const char* charset;   // characters of the glyphs, in order
+  const PageGlyph_t* glyphs;
+  const uint8_t* bitmap;  // columns of all glyphs, one byte per page of the cell
+  uint8_t pages;          // height of the cell, the font bounding box from its top
+  uint8_t ascent;         // rows of the cell above the baseline
+} PageFont_t;
+
+/**
+ * @brief  Rasterize the glyphs of a charset into a page font.
+ * @note   The frame buffer is used as scratch area and left as it was, a page
+ *         buffer window is moved over the cell and back.
+ * @param  page_font: page font instance
+ * @param  u8g2: u8g2 instance with a vertical_top_lsb buffer at least PAGE_FONT_MAX_WIDTH wide
+ * @param  font: u8g2 font
+ * @param  charset: characters to pre-decode, must stay valid
+ * @param  glyphs: storage for one glyph per character of the charset
+ * @param  bitmap: storage for the columns of the glyphs
+ * @param  size: bytes of the bitmap
+ * @retval Bytes of the bitmap used, 0 if a glyph is missing, too large or does not fit
+ */
+uint16_t PageFont_Init(PageFont_t* page_font, u8g2_t* u8g2, const uint8_t* font, const char* charset,
+                       PageGlyph_t* glyphs, uint8_t* bitmap, uint16_t size);
+
+/**
+ * @brief  Draw one character.
+ * @param  page_font: page font instance
+ * @param  u8g2: u8g2 instance
+ * @param  x: cursor
+ * @param  y: baseline
+ * @param  encoding: character
+ * @retval Advance of the cursor
+ */
+u8g2_uint_t PageFont_DrawGlyph(const PageFont_t* page_font, u8g2_t* u8g2, u8g2_uint_t x, u8g2_uint_t y,
+                               uint16_t encoding);
+
+/**
+ * @brief  Draw a string like u8g2_DrawStr() with the font of the page font.
+ * @param  page_font: page font instance
+ * @param  u8g2: u8g2 instance
+ * @param  x: cursor of the first character
+ * @param  y: baseline, independent of the font position of u8g2
+ * @param  str: 8 bit characters, ends at '\0' or '\n'
+ * @retval Width of the string
+ */
+u8g2_uint_t PageFont_DrawStr(const PageFont_t* page_font, u8g2_t* u8g2, u8g2_uint_t x, u8g2_uint_t y,
+                             const char* str);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // PAGE_FONT_H
@@ -0,0 +1,40 @@
+#ifndef RENDER_BENCH_H
+#define RENDER_BENCH_H
+
+#include <stdint.h>
+
+#include "u8g2.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Micro-benchmarks of the rendering hot path.
+ *
+ * Every case runs RENDER_BENCH_RUNS batches of its iterations and reports the
+ * fastest and the average batch, per iteration, in the unit of the cycle
+ * counter (CPU cycles from the DWT on the target, nanoseconds on the host).
+ * The fastest batch filters out preemption by other tasks.
+ *
+ * Each result is one JSON object per line, e.g.
+ *   {"bench":"u8g2_DrawRBox","unit":"cycles","iterations":64,"min":1510,"avg":1523}
+ * so runs can be collected and compared commit by commit.
+ */
+
+#define RENDER_BENCH_RUNS 8
+
+/**
+ * @brief  Run all benchmark cases.
+ * @note   Draws the face singleton, call it before Face_Init().
+ * @param  u8g2: full buffer u8g2 instance to draw into, its buffer is cleared afterwards
+ * @param  emit: called with every result line (without line ending)
+ * @retval None
+ */
+void RenderBench_Run(u8g2_t* u8g2, void (*emit)(const char* line));
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RENDER_BENCH_H
@@ -0,0 +1,60 @@
+#ifndef SENSOR_MAILBOX_H
+#define SENSOR_MAILBOX_H
+
+#include <stdatomic.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Latest-value channel from the sensor task to its readers.
+ *
+ * The mailbox holds one reading, a new one overwrites it: readers always see
+ * the most recent value and a slow reader never makes the writer drop data or
+ * wait. The value is guarded by a sequence counter (a seqlock), odd while the
+ * writer copies a reading in. Readers copy it out and retry if the counter
+ * moved meanwhile, nobody takes a lock.
+ *
+ * Single writer, readers must not preempt it: a reader of higher priority
+ * would spin on a write it interrupted. Readers keep the version of the value
+ * they saw last, SensorMailbox_Read() tells them whether the value has changed
+ * since. Publishing a reading equal to the held one only refreshes its
+ * timestamp, the version stays the same.
+ */
+
+typedef struct {
+  int16_t temperature;  // tenths of °C
+  uint16_t humidity;    // tenths of %RH
+  uint32_t timestamp;   // Timestamp_Micros() of the measurement
+} SensorReading_t;
+
+typedef struct {
+  _Atomic uint32_t seq;  // odd while a write is in progress
+  uint32_t version;      // number of value changes, 0 before the first reading
+  SensorReading_t reading;
+} SensorMailbox_t;
+
+/**
+ * @brief  Store a reading, overwriting the previous one.
+ * @param  mailbox: mailbox instance
+ * @param  reading: new reading
+ * @retval 1 if temperature or humidity differ from the previous reading, else 0
+ */
+uint8_t SensorMailbox_Publish(SensorMailbox_t* mailbox, const SensorReading_t* reading);
+
+/**
+ * @brief  Copy the latest reading.
+ * @param  mailbox: mailbox instance
+ * @param  reading: receives the reading
+ * @param  version: version seen last, updated to the version copied, start at 0
+ * @retval 1 if the value changed since version, 0 if not or nothing was published yet
+ */
+uint8_t SensorMailbox_Read(SensorMailbox_t* mailbox, SensorReading_t* reading, uint32_t* version);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // SENSOR_MAILBOX_H
@@ -0,0 +1,100 @@
+#ifndef TEXT_OVERLAY_H
+#define TEXT_OVERLAY_H
+
+#include <stdint.h>
+
+#include "display_list.h"
+#include "page_font.h"
+#include "u8g2.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Cached text on a page-aligned area of the frame buffer.
+ *
+ * Drawing a string with u8g2 decodes every glyph of the compressed font bit by
+ * bit. An overlay keeps the rasterized string instead: a bitmap of the area in
+ * the layout of the frame buffer (vertical bytes, LSB on top, one row of bytes
+ * per page), rendered only when the text changes. Drawing it in a frame is a
+ * byte copy per column.
+ *
+ * The text is rasterized by u8g2 itself, in the frame buffer: the area is
+ * saved into the bitmap and cleared, the string drawn clipped to it, then the
+ * area and the bitmap are swapped. The frame content is left as it was, so the
+ * text may be set at any point of a frame.
+ *
+ * With a page buffer, only the pages of the area in the current buffer window
+ * are drawn. Setting the text moves the window over the area and back.
+ *
+ * With a page font of the same font, the characters it has are blitted from
+ * pre-decoded columns instead of decoded by u8g2.
+ */
+
+#define TEXT_OVERLAY_TEXT_MAX 16
+
+typedef struct {
+  uint8_t* bitmap;    // width * pages bytes
+  const uint8_t* font;
+  const PageFont_t* page_font;  // NULL, or pre-decoded glyphs of font
+  uint8_t x;          // left column
+  uint8_t page;       // top page, y / 8
+  uint8_t width;      // in pixels
+  uint8_t pages;      // height in pages of 8 pixels
+  uint16_t revision;  // counts text changes
+  char text[TEXT_OVERLAY_TEXT_MAX];
+} TextOverlay_t;
+
+/**
+ * @brief  Place an empty overlay.
+ * @param  overlay: overlay instance
+ * @param  bitmap: storage for the rasterized text, width * pages bytes
+ * @param  x: left column of the area
+ * @param  page: top page of the area
+ * @param  width: width of the area in pixels
+ * @param  pages: height of the area in pages
+ * @param  font: u8g2 font, glyphs are drawn from the top of the area
+ * @retval None
+ */
+void TextOverlay_Init(TextOverlay_t* overlay, uint8_t* bitmap, uint8_t x, uint8_t page, uint8_t width, uint8_t pages,
+                      const uint8_t* font);
+
+/**
+ * @brief  Rasterize the text with the glyphs of a page font, from the next text change on.
+ * @param  overlay: overlay instance
+ * @param  page_font: page font set up with the font of the overlay, NULL for u8g2 only
+ * @retval None
+ */
+void TextOverlay_SetPageFont(TextOverlay_t* overlay, const PageFont_t* page_font);
+
+/**
+ * @brief  Change the text, rasterized only if it differs from the current one.
+ * @param  overlay: overlay instance
+ * @param  u8g2: u8g2 instance the overlay is drawn to
+ * @param  text: new text, truncated to TEXT_OVERLAY_TEXT_MAX - 1 characters
+ * @retval 1 if the text changed, else 0
+ */
+uint8_t TextOverlay_SetText(TextOverlay_t* overlay, u8g2_t* u8g2, const char* text);
+
+/**
+ * @brief  Draw the cached text into the frame buffer, set pixels are or-ed in.
+ * @param  overlay: overlay instance
+ * @param  u8g2: u8g2 instance, of a page buffer only the pages in its window are drawn
+ * @retval None
+ */
+void TextOverlay_Draw(const TextOverlay_t* overlay, u8g2_t* u8g2);
+
+/**
+ * @brief  Record TextOverlay_Draw() into a display list, with the revision of the text.
+ * @param  overlay: overlay instance, must stay valid until the list is rendered
+ * @param  list: display list of the frame
+ * @retval 1 if recorded, 0 if the list is full
+ */
+uint8_t TextOverlay_Record(const TextOverlay_t* overlay, DisplayList_t* list);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // TEXT_OVERLAY_H
@@ -0,0 +1,70 @@
+#ifndef TIMESTAMP_H
+#define TIMESTAMP_H
+
+#include <stdint.h>
+
+#include "stm32f1xx.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Monotonic 32-bit microsecond timestamps, wrap after ~71.6 minutes.
+ *
+ * TIM3 counts at 1 MHz, its update interrupt extends the 16-bit counter with
+ * g_HighFrequencyTimerTicks (main.c). The read takes both halves without
+ * disabling interrupts and accounts for an overflow whose interrupt has not
+ * run yet. TIM3_IRQHandler() clears the overflow flag and counts it with
+ * interrupts disabled, so no reader sees the flag cleared before the count.
+ * The read is valid in any context, including critical sections and ISRs of
+ * higher priority than TIM3. Also the FreeRTOS run-time stats clock.
+ */
+
+extern volatile uint32_t g_HighFrequencyTimerTicks;
+
+/**
+ * @brief  Start the timestamp timer, called before the scheduler starts.
+ * @retval None
+ */
+void Timestamp_Init(void);
+
+/**
+ * @brief  Current timestamp.
+ * @retval Microseconds since Timestamp_Init()
+ */
+static inline uint32_t Timestamp_Micros(void) {
+  uint32_t high, count, pending;
+  do {
+    high = g_HighFrequencyTimerTicks;
+    count = TIM3->CNT;
+    pending = TIM3->SR & TIM_SR_UIF;
+  } while (high != g_HighFrequencyTimerTicks);
+
+  // The counter wrapped but the update interrupt has not counted it yet
+  if (pending && count < 0x8000U) high++;
+
+  return (high << 16) | count;
+}
+
+/**
+ * @brief  Move the timestamp forward, for time TIM3 did not count (STOP mode).
+ *         Call with interrupts disabled.
+ * @param  us: microseconds to add
+ * @retval None
+ */
+static inline void Timestamp_Advance(uint32_t us) {
+  uint32_t now = Timestamp_Micros() + us;
+
+  TIM3->CR1 &= ~TIM_CR1_CEN;
+  g_HighFrequencyTimerTicks = now >> 16;
+  TIM3->CNT = now & 0xFFFFU;
+  TIM3->SR = (uint16_t)~TIM_SR_UIF;  // a pending overflow is already in now
+  TIM3->CR1 |= TIM_CR1_CEN;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // TIMESTAMP_H
@@ -0,0 +1,80 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+
+#include "trace_format.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Deferred trace logging.
+ *
+ *   TRACE("[USER] missed %lu frame deadline(s)", missed);
+ *
+ * With TRACE_BINARY the call site only queues the id of its format string,
+ * a microsecond timestamp and the raw arguments (see trace_format.h), formatting happens on
+ * the host with trace_decode. Otherwise TRACE is Log_Printf with a line
+ * ending. The format string is a literal, arguments are integers of at most
+ * 32 bits, at most TRACE_MAX_ARGS, each converted to a word (also from C++),
+ * %s and floating point are not supported.
+ */
+
+#if TRACE_BINARY
+
+#ifdef __cplusplus
+#define TRACE_STATIC_ASSERT static_assert
+#else
+#define TRACE_STATIC_ASSERT _Static_assert
+#endif
+
+// The format string travels in __VA_ARGS__ so a call without arguments still
+// counts in ISO C++, and every argument is converted to a word because a braced
+// list must not narrow there
+#define TRACE_ARG(x) ((uint32_t)(x))
+#define TRACE_ARGS_0(fmt) 0
+#define TRACE_ARGS_1(fmt, a) 0, TRACE_ARG(a)
+#define TRACE_ARGS_2(fmt, a, b) TRACE_ARGS_1(fmt, a), TRACE_ARG(b)
+#define TRACE_ARGS_3(fmt, a, b, c) TRACE_ARGS_2(fmt, a, b), TRACE_ARG(c)
+#define TRACE_ARGS_4(fmt, a, b, c, d) TRACE_ARGS_3(fmt, a, b, c), TRACE_ARG(d)
+#define TRACE_ARGS_5(fmt, a, b, c, d, e) TRACE_ARGS_4(fmt, a, b, c, d), TRACE_ARG(e)
+#define TRACE_ARGS_6(fmt, a, b, c, d, e, f) TRACE_ARGS_5(fmt, a, b, c, d, e), TRACE_ARG(f)
+#define TRACE_NARGS(...) TRACE_NARGS_(__VA_ARGS__, 6, 5, 4, 3, 2, 1, 0, )
+#define TRACE_NARGS_(fmt, _1, _2, _3, _4, _5, _6, n, ...) n
+#define TRACE_FMT(...) TRACE_FMT_(__VA_ARGS__, )
+#define TRACE_FMT_(fmt, ...) fmt
+#define TRACE_CAT(a, b) TRACE_CAT_(a, b)
+#define TRACE_CAT_(a, b) a##b
+
+#define TRACE(...)                                                                                          \
+  do {                                                                                                      \
+    static const char trace_fmt_[] __attribute__((section(".trace_fmt"), used)) = TRACE_FMT(__VA_ARGS__);  \
+    const uint32_t trace_args_[] = {TRACE_CAT(TRACE_ARGS_, TRACE_NARGS(__VA_ARGS__))(__VA_ARGS__)};         \
+    TRACE_STATIC_ASSERT(sizeof(trace_args_) / 4 - 1 <= TRACE_MAX_ARGS, "too many trace arguments");         \
+    Trace_Write((uint16_t)(uintptr_t)trace_fmt_, trace_args_ + 1, sizeof(trace_args_) / 4 - 1);            \
+  } while (0)
+
+/**
+ * @brief  Queue a trace record, use TRACE(). Safe to call from an ISR.
+ * @param  id: offset of the format string in .trace_fmt
+ * @param  args: argument words
+ * @param  count: number of argument words
+ * @retval None
+ */
+void Trace_Write(uint16_t id, const uint32_t* args, uint32_t count);
+
+#else
+
+#include "log.h"
+
+#define TRACE(fmt, ...) Log_Printf(fmt "\r\n", ##__VA_ARGS__)
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // TRACE_H
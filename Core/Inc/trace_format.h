@@ -0,0 +1,22 @@
+#ifndef TRACE_FORMAT_H
+#define TRACE_FORMAT_H
+
+/*
+ * Binary trace record, shared by the firmware and the host decoder. All
+ * fields are little endian, records are mixed with text in the log stream.
+ *
+ *   byte 0      TRACE_RECORD_MARK, does not occur in text
+ *   byte 1      number of argument words
+ *   bytes 2-3   message id, offset of the format string in .trace_fmt
+ *   bytes 4-7   timestamp in us (Timestamp_Micros)
+ *   then        one 32-bit word per argument
+ *
+ * The format strings are kept out of flash in the .trace_fmt section of the
+ * ELF, the build dumps it to <project>.trace_fmt as NUL-terminated strings.
+ */
+
+#define TRACE_RECORD_MARK 0x1E  // ASCII record separator
+#define TRACE_HEADER_SIZE 8
+#define TRACE_MAX_ARGS 6
+
+#endif  // TRACE_FORMAT_H
@@ -0,0 +1,215 @@
+#include "display_list.h"
+
+#include <stddef.h>
+
+#define FNV_OFFSET 2166136261UL
+#define FNV_PRIME 16777619UL
+
+// FNV-1a over the bytes of a value
+static uint32_t display_list_hash(uint32_t hash, uint32_t value, uint8_t bytes) {
+  for (uint8_t i = 0; i < bytes; i++) {
+    hash = (hash ^ (value & 0xff)) * FNV_PRIME;
+    value >>= 8;
+  }
+  return hash;
+}
+
+// Field by field, padding bytes of the command are undefined
+static uint32_t display_list_hash_command(uint32_t hash, const DisplayCommand_t* command) {
+  hash = display_list_hash(hash, (uint32_t)(uintptr_t)command->draw, sizeof(uint32_t));
+  hash = display_list_hash(hash, (uint32_t)(uintptr_t)command->data, sizeof(uint32_t));
+  hash = display_list_hash(hash, (uint16_t)command->x, 2);
+  hash = display_list_hash(hash, (uint16_t)command->y, 2);
+  hash = display_list_hash(hash, command->w, 1);
+  hash = display_list_hash(hash, command->h, 1);
+  return display_list_hash(hash, command->param, 2);
+}
+
+static uint8_t display_list_is_in_rows(const DisplayCommand_t* command, int16_t y0, int16_t y1) {
+  return command->y < y1 && command->y + command->h > y0;
+}
+
+void DisplayList_Init(DisplayList_t* list, DisplayCommand_t* commands, uint8_t capacity) {
+  list->commands = commands;
+  list->capacity = capacity;
+  list->frame_bytes_sent = 0;
+  list->frame_bytes_skipped = 0;
+  list->total_bytes_sent = 0;
+  list->total_bytes_skipped = 0;
+  list->transport = NULL;
+  DisplayList_Clear(list);
+  DisplayList_Invalidate(list);
+}
+
+void DisplayList_SetTransport(DisplayList_t* list, u8g2_t* u8g2, const DisplayTransport_t* transport,
+                              uint8_t* buffer) {
+  list->transport = transport;
+  list->buffers[0] = u8g2->tile_buf_ptr;
+  list->buffers[1] = buffer;
+  list->is_sending[0] = 0;
+  list->is_sending[1] = 0;
+  list->buffer = 0;
+}
+
+// Returns 0 if the tiles sent from the buffer may not have reached the display
+static uint8_t display_list_wait(DisplayList_t* list, uint8_t buffer) {
+  if (!list->is_sending[buffer]) return 1;
+  list->is_sending[buffer] = 0;
+  return list->transport->wait(list->fences[buffer]);
+}
+
+void DisplayList_Sync(DisplayList_t* list, u8g2_t* u8g2) {
+  if (list->transport == NULL) return;
+  uint8_t is_sent = display_list_wait(list, 0);
+  is_sent &= display_list_wait(list, 1);
+  if (!is_sent) DisplayList_Invalidate(list);
+  u8g2->tile_buf_ptr = list->buffers[0];
+}
+
+void DisplayList_Clear(DisplayList_t* list) {
+  list->count = 0;
+  list->dropped = 0;
+}
+
+void DisplayList_Invalidate(DisplayList_t* list) { list->is_valid = 0; }
+
+uint8_t DisplayList_Add(DisplayList_t* list, DisplayDrawFn draw, const void* data, int16_t x, int16_t y, uint8_t w,
+                        uint8_t h, uint16_t param) {
+  if (list->count >= list->capacity) {
+    if (list->dropped < UINT8_MAX) list->dropped++;
+    return 0;
+  }
+  DisplayCommand_t* command = &list->commands[list->count++];
+  command->draw = draw;
+  command->data = data;
+  command->x = x;
+  command->y = y;
+  command->w = w;
+  command->h = h;
+  command->param = param;
+  return 1;
+}
+
+// --- u8g2 primitives, the arguments are taken back from the bounding box ---
+static void display_list_draw_box(u8g2_t* u8g2, const DisplayCommand_t* command) {
+  u8g2_DrawBox(u8g2, command->x, command->y, command->w, command->h);
+}
+
+static void display_list_draw_rbox(u8g2_t* u8g2, const DisplayCommand_t* command) {
+  u8g2_DrawRBox(u8g2, command->x, command->y, command->w, command->h, command->param);
+}
+
+static void display_list_draw_disc(u8g2_t* u8g2, const DisplayCommand_t* command) {
+  u8g2_uint_t r = command->w / 2;
+  u8g2_DrawDisc(u8g2, command->x + r, command->y + r, r, command->param);
+}
+
+static void display_list_draw_hline(u8g2_t* u8g2, const DisplayCommand_t* command) {
+  u8g2_DrawHLine(u8g2, command->x, command->y, command->w);
+}
+
+uint8_t DisplayList_Box(DisplayList_t* list, int16_t x, int16_t y, uint8_t w, uint8_t h) {
+  return DisplayList_Add(list, display_list_draw_box, NULL, x, y, w, h, 0);
+}
+
+uint8_t DisplayList_RBox(DisplayList_t* list, int16_t x, int16_t y, uint8_t w, uint8_t h, uint8_t r) {
+  return DisplayList_Add(list, display_list_draw_rbox, NULL, x, y, w, h, r);
+}
+
+uint8_t DisplayList_Disc(DisplayList_t* list, int16_t x, int16_t y, uint8_t r, uint8_t option) {
+  return DisplayList_Add(list, display_list_draw_disc, NULL, x - r, y - r, 2 * r + 1, 2 * r + 1, option);
+}
+
+uint8_t DisplayList_HLine(DisplayList_t* list, int16_t x, int16_t y, uint8_t w) {
+  return DisplayList_Add(list, display_list_draw_hline, NULL, x, y, w, 1, 0);
+}
+
+void DisplayList_Replay(const DisplayList_t* list, u8g2_t* u8g2) {
+  int16_t y0 = u8g2->tile_curr_row * 8;
+  int16_t y1 = y0 + u8g2->tile_buf_height * 8;
+  for (uint8_t i = 0; i < list->count; i++) {
+    const DisplayCommand_t* command = &list->commands[i];
+    if (display_list_is_in_rows(command, y0, y1)) {
+      command->draw(u8g2, command);
+    }
+  }
+}
+
+uint8_t DisplayList_Render(DisplayList_t* list, u8g2_t* u8g2) {
+  u8x8_t* u8x8 = u8g2_GetU8x8(u8g2);
+  uint8_t tile_width = u8x8->display_info->tile_width;
+  uint8_t tile_height = u8x8->display_info->tile_height;
+  uint8_t rows = u8g2_GetBufferTileHeight(u8g2);
+  uint8_t sent = 0;
+  uint16_t bytes_sent = 0;
+  uint8_t is_sent = 1;
+
+  for (uint8_t row = 0, window = 0; row < tile_height; row += rows, window++) {
+    int16_t y0 = row * 8;
+    int16_t y1 = y0 + rows * 8;
+    uint32_t hash = FNV_OFFSET;
+    uint8_t tx0 = tile_width;
+    uint8_t tx1 = 0;
+
+    for (uint8_t i = 0; i < list->count; i++) {
+      const DisplayCommand_t* command = &list->commands[i];
+      if (!display_list_is_in_rows(command, y0, y1)) continue;
+      hash = display_list_hash_command(hash, command);
+
+      int16_t x0 = command->x < 0 ? 0 : command->x;
+      int16_t x1 = command->x + command->w;
+      if (x1 > tile_width * 8) x1 = tile_width * 8;
+      if (x0 >= x1) continue;
+      if (x0 / 8 < tx0) tx0 = x0 / 8;
+      if ((x1 + 7) / 8 > tx1) tx1 = (x1 + 7) / 8;
+    }
+
+    // Send the columns drawn now and those to erase from the last frame
+    uint8_t send_tx0 = 0;
+    uint8_t send_tx1 = tile_width;
+    if (window < DISPLAY_LIST_PAGES) {
+      if (list->is_valid) {
+        if (hash == list->page_hash[window]) continue;
+        send_tx0 = tx0 < list->page_tx0[window] ? tx0 : list->page_tx0[window];
+        send_tx1 = tx1 > list->page_tx1[window] ? tx1 : list->page_tx1[window];
+      }
+      list->page_hash[window] = hash;
+      list->page_tx0[window] = tx0;
+      list->page_tx1[window] = tx1;
+    }
+
+    if (send_tx0 < send_tx1) {
+      uint8_t buffer = list->buffer;
+      if (list->transport != NULL) {
+        // Rendered into while the tiles of the other buffer are sent
+        is_sent &= display_list_wait(list, buffer);
+        u8g2->tile_buf_ptr = list->buffers[buffer];
+      }
+      u8g2_SetBufferCurrTileRow(u8g2, row);
+      u8g2_ClearBuffer(u8g2);
+      DisplayList_Replay(list, u8g2);
+      for (uint8_t r = 0; r < rows && row + r < tile_height; r++) {
+        uint8_t* tiles = u8g2_GetBufferPtr(u8g2) + r * u8g2->pixel_buf_width + send_tx0 * 8;
+        if (list->transport != NULL) {
+          list->fences[buffer] = list->transport->send(u8g2, send_tx0, row + r, send_tx1 - send_tx0, tiles);
+          list->is_sending[buffer] = 1;
+        } else {
+          u8x8_DrawTile(u8x8, send_tx0, row + r, send_tx1 - send_tx0, tiles);
+        }
+        bytes_sent += (send_tx1 - send_tx0) * 8;
+      }
+      list->buffer = buffer ^ 1;
+      sent++;
+    }
+  }
+
+  u8g2_SetBufferCurrTileRow(u8g2, 0);
+  if (list->transport != NULL) u8g2->tile_buf_ptr = list->buffers[0];
+  // A window lost by the transport is sent again with the next frame
+  list->is_valid = is_sent;
+  list->frame_bytes_sent = bytes_sent;
+  list->frame_bytes_skipped = tile_width * tile_height * 8 - bytes_sent;
+  list->total_bytes_sent += list->frame_bytes_sent;
+  list->total_bytes_skipped += list->frame_bytes_skipped;
+  return sent;
+}
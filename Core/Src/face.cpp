@@ -4,6 +4,10 @@
 #include <cstdlib>
 
 #include "cmsis_os.h"
+#include "easing.hpp"
+#ifdef FACE_BENCHMARK
+#include "cycle_counter.h"
+#endif
 
 Face g_faceInstance;
 
@@ -21,6 +25,11 @@ Face g_faceInstance;
 #define EYE_CORNER_RADIUS 4
 #define LOOK_OFFSET_X 10
 
+// Draw the eyes from the precomputed sprites instead of u8g2_DrawRBox
+#ifndef FACE_USE_EYE_SPRITES
+#define FACE_USE_EYE_SPRITES 1
+#endif
+
 #define LOOK_TRANSITION_MS 120
 #define BLINK_DURATION_MS 100
 #define BLINK_CLOSED_MS 60
@@ -37,27 +46,310 @@ static uint32_t getRandomInterval(uint32_t min, uint32_t max) {
   return min + (rand() % (max - min + 1));
 }
 
-static void drawEyes(u8g2_t* u8g2, int eye_height, int x_offset) {
-  int screen_center_x = SCREEN_WIDTH / 2;
-  int left_eye_center_x = screen_center_x - EYE_OFFSET_X + x_offset;
-  int right_eye_center_x = screen_center_x + EYE_OFFSET_X + x_offset;
+// Tick comparison that survives the 32-bit wrap around
+static bool isTimeBefore(uint32_t a, uint32_t b) { return (int32_t)(a - b) < 0; }
+
+// Corner radius for an eye of the given height. u8g2_DrawRBox needs h >= 2 * r,
+// otherwise its height arithmetic wraps around and it fills whole columns.
+static constexpr int eyeCornerRadius(int eye_height) {
+  return eye_height / 2 < EYE_CORNER_RADIUS ? eye_height / 2 : EYE_CORNER_RADIUS;
+}
+
+// --- Eye Sprite Cache ---
+// Every eye height is rasterized at compile time into page aligned column
+// masks, bit n of a column is pixel row EYE_SPRITE_TOP_Y + n. The rasterizer
+// below follows u8g2_DrawRBox/u8g2_DrawDisc step by step, so a sprite has the
+// same pixels as the u8g2 drawing. Drawing an eye becomes an OR of 4 bytes per
+// column into the frame buffer.
+#define EYE_SPRITE_TOP_Y (((EYE_CENTER_Y - EYE_HEIGHT / 2) / 8) * 8)
+#define EYE_SPRITE_PAGES 4
+
+namespace {
+
+struct EyeSprite {
+  uint32_t columns[EYE_WIDTH];
+};
+
+struct EyeSpriteTable {
+  EyeSprite sprites[EYE_HEIGHT + 1];
+  bool clipped;  // a pixel fell outside of the sprite, checked below
+};
+
+constexpr void spriteVLine(EyeSprite& sprite, bool& clipped, int x, int y, int len) {
+  for (int i = 0; i < len; i++) {
+    int row = y + i - EYE_SPRITE_TOP_Y;
+    if (x < 0 || x >= EYE_WIDTH || row < 0 || row >= EYE_SPRITE_PAGES * 8) {
+      clipped = true;
+    } else {
+      sprite.columns[x] |= 1UL << row;
+    }
+  }
+}
+
+constexpr void spriteBox(EyeSprite& sprite, bool& clipped, int x, int y, int w, int h) {
+  for (int i = 0; i < w; i++) {
+    spriteVLine(sprite, clipped, x + i, y, h);
+  }
+}
+
+// One quadrant of u8g2_draw_disc()
+constexpr void spriteDiscQuadrant(EyeSprite& sprite, bool& clipped, int x0, int y0, int rad, bool right, bool lower) {
+  int f = 1 - rad;
+  int ddF_x = 1;
+  int ddF_y = -2 * rad;
+  int x = 0;
+  int y = rad;
+  int sx = right ? 1 : -1;
+
+  for (;;) {
+    if (lower) {
+      spriteVLine(sprite, clipped, x0 + sx * x, y0, y + 1);
+      spriteVLine(sprite, clipped, x0 + sx * y, y0, x + 1);
+    } else {
+      spriteVLine(sprite, clipped, x0 + sx * x, y0 - y, y + 1);
+      spriteVLine(sprite, clipped, x0 + sx * y, y0 - x, x + 1);
+    }
+    if (x >= y) break;
+    if (f >= 0) {
+      y--;
+      ddF_y += 2;
+      f += ddF_y;
+    }
+    x++;
+    ddF_x += 2;
+    f += ddF_x;
+  }
+}
+
+// Same steps as u8g2_DrawRBox(u8g2, 0, y, w, h, r)
+constexpr void spriteRBox(EyeSprite& sprite, bool& clipped, int y, int w, int h, int r) {
+  int xl = r;
+  int yu = y + r;
+  int xr = w - r - 1;
+  int yl = y + h - r - 1;
+
+  spriteDiscQuadrant(sprite, clipped, xl, yu, r, false, false);
+  spriteDiscQuadrant(sprite, clipped, xr, yu, r, true, false);
+  spriteDiscQuadrant(sprite, clipped, xl, yl, r, false, true);
+  spriteDiscQuadrant(sprite, clipped, xr, yl, r, true, true);
+
+  int ww = w - 2 * r;
+  int hh = h - 2 * r;
+  if (ww >= 3) {
+    spriteBox(sprite, clipped, xl + 1, y, ww - 2, r + 1);
+    spriteBox(sprite, clipped, xl + 1, yl, ww - 2, r + 1);
+  }
+  if (hh >= 3) {
+    spriteBox(sprite, clipped, 0, yu + 1, w, hh - 2);
+  }
+}
+
+constexpr EyeSpriteTable makeEyeSprites() {
+  EyeSpriteTable table{};
+  for (int h = 0; h <= EYE_HEIGHT; h++) {
+    EyeSprite& sprite = table.sprites[h];
+    if (h <= 2) {
+      spriteBox(sprite, table.clipped, 0, EYE_CENTER_Y, EYE_WIDTH, 1);
+    } else {
+      spriteRBox(sprite, table.clipped, EYE_CENTER_Y - h / 2, EYE_WIDTH, h, eyeCornerRadius(h));
+    }
+  }
+  return table;
+}
+
+constexpr EyeSpriteTable eye_sprites = makeEyeSprites();
+static_assert(!eye_sprites.clipped, "eye does not fit into the sprite pages");
+
+}  // namespace
+
+// Blit the sprite of one eye without its top lid rows, returns false if the
+// target can not take the fast path (rotation, buffer format, draw color or clipping)
+static bool drawEyeSprite(u8g2_t* u8g2, int x, int y_offset, int eye_height, int lid) {
+  if (u8g2->cb != U8G2_R0 || u8g2->ll_hvline != u8g2_ll_hvline_vertical_top_lsb || u8g2->draw_color != 1) {
+    return false;
+  }
+  int top_y = EYE_SPRITE_TOP_Y + y_offset;
+  if (x < 0 || x + EYE_WIDTH > u8g2->pixel_buf_width || top_y < 0) {
+    return false;
+  }
+#ifdef U8G2_WITH_CLIP_WINDOW_SUPPORT
+  if (x < u8g2->clip_x0 || x + EYE_WIDTH > u8g2->clip_x1 || top_y < u8g2->clip_y0 ||
+      top_y + EYE_SPRITE_PAGES * 8 > u8g2->clip_y1) {
+    return false;
+  }
+#endif
+
+  // A vertical offset that is not a multiple of 8 spreads the sprite over one more page
+  const EyeSprite& sprite = eye_sprites.sprites[eye_height];
+  uint32_t lid_mask = UINT32_MAX;
+  if (eye_height > 2 && lid > 0) {
+    lid_mask <<= EYE_CENTER_Y - eye_height / 2 - EYE_SPRITE_TOP_Y + lid;
+  }
+  int first_page = top_y / 8;
+  int shift = top_y % 8;
+  int pages = shift ? EYE_SPRITE_PAGES + 1 : EYE_SPRITE_PAGES;
+  for (int i = 0; i < pages; i++) {
+    // In page buffer mode only the pages of the current window are present
+    int row = first_page + i - u8g2->tile_curr_row;
+    if (row < 0 || row >= u8g2->tile_buf_height) continue;
+
+    uint8_t* dst = u8g2->tile_buf_ptr + row * u8g2->pixel_buf_width + x;
+    for (int col = 0; col < EYE_WIDTH; col++) {
+      dst[col] |= (uint8_t)(((uint64_t)(sprite.columns[col] & lid_mask) << shift) >> (i * 8));
+    }
+  }
+  return true;
+}
 
+static void drawEyeRBox(u8g2_t* u8g2, int x, int y_offset, int eye_height, int lid) {
   if (eye_height <= 2) {
-    u8g2_DrawHLine(u8g2, left_eye_center_x - EYE_WIDTH / 2, EYE_CENTER_Y, EYE_WIDTH);
-    u8g2_DrawHLine(u8g2, right_eye_center_x - EYE_WIDTH / 2, EYE_CENTER_Y, EYE_WIDTH);
+    u8g2_DrawHLine(u8g2, x, EYE_CENTER_Y + y_offset, EYE_WIDTH);
   } else {
-    int top_y = EYE_CENTER_Y - eye_height / 2;
-    u8g2_DrawRBox(u8g2, left_eye_center_x - EYE_WIDTH / 2, top_y, EYE_WIDTH, eye_height, EYE_CORNER_RADIUS);
-    u8g2_DrawRBox(u8g2, right_eye_center_x - EYE_WIDTH / 2, top_y, EYE_WIDTH, eye_height, EYE_CORNER_RADIUS);
+    int top_y = EYE_CENTER_Y + y_offset - eye_height / 2;
+    // The lid rows are clipped away, the rest of the eye keeps its round corners
+    if (lid > 0) u8g2_SetClipWindow(u8g2, x, top_y + lid, x + EYE_WIDTH, top_y + eye_height);
+    u8g2_DrawRBox(u8g2, x, top_y, EYE_WIDTH, eye_height, eyeCornerRadius(eye_height));
+    if (lid > 0) u8g2_SetMaxClipWindow(u8g2);
   }
 }
 
-// --- Look-Up Table for Sine Easing ---
-// Represents the first quadrant of a sine wave, scaled to 0-255
-// Placed in Flash memory due to 'const'
-const uint8_t sine_lut_q1[] = {0,   12,  25,  37,  50,  62,  74,  86,  98,  109, 121, 132, 143, 153, 163, 173,
-                               182, 191, 200, 208, 216, 223, 230, 236, 242, 246, 250, 253, 255, 255, 255, 255};
-const int SINE_LUT_SIZE = sizeof(sine_lut_q1) / sizeof(sine_lut_q1[0]);
+// Draws an eye recorded by drawEye(), param holds the height and the lid, the
+// vertical offset is taken back from the bottom of the bounding box
+static void replayEye(u8g2_t* u8g2, const DisplayCommand_t* command) {
+  int eye_height = command->param & 0xff;
+  int lid = command->param >> 8;
+  int y_offset = command->y - EYE_CENTER_Y;
+  if (eye_height > 2) y_offset = command->y + command->h - eye_height + eye_height / 2 - EYE_CENTER_Y;
+
+#if FACE_USE_EYE_SPRITES
+  if (drawEyeSprite(u8g2, command->x, y_offset, eye_height, lid)) {
+    return;
+  }
+#endif
+  drawEyeRBox(u8g2, command->x, y_offset, eye_height, lid);
+}
+
+static void drawEye(DisplayList_t* list, int x, int y_offset, int eye_height, int lid) {
+  if (eye_height < 0) eye_height = 0;
+  if (eye_height > EYE_HEIGHT) eye_height = EYE_HEIGHT;
+
+  // Bounding box of the pixels, a closed eye is a line, the lid keeps at least its bottom row
+  int top_y = EYE_CENTER_Y + y_offset;
+  int h = 1;
+  if (eye_height > 2) {
+    if (lid < 0) lid = 0;
+    if (lid > eye_height - 1) lid = eye_height - 1;
+    top_y -= eye_height / 2 - lid;
+    h = eye_height - lid;
+  } else {
+    lid = 0;
+  }
+  DisplayList_Add(list, replayEye, nullptr, x, top_y, EYE_WIDTH, h, (uint16_t)((lid << 8) | eye_height));
+}
+
+static void drawPose(DisplayList_t* list, const FacePose& pose) {
+  int screen_center_x = SCREEN_WIDTH / 2;
+  int left_eye_x = screen_center_x - EYE_OFFSET_X + pose.offsetX - EYE_WIDTH / 2;
+  int right_eye_x = screen_center_x + EYE_OFFSET_X + pose.offsetX - EYE_WIDTH / 2;
+
+  drawEye(list, left_eye_x, pose.offsetY, pose.leftHeight, pose.leftLid);
+  drawEye(list, right_eye_x, pose.offsetY, pose.rightHeight, pose.rightLid);
+}
+
+static void drawEyes(DisplayList_t* list, int eye_height, int x_offset) {
+  FacePose pose = {(int16_t)eye_height, (int16_t)eye_height, (int16_t)x_offset, 0};
+  drawPose(list, pose);
+}
+
+#ifdef FACE_BENCHMARK
+void benchmarkEyeDrawing(u8g2_t* u8g2, uint32_t* rboxCycles, uint32_t* spriteCycles) {
+  int left_eye_x = SCREEN_WIDTH / 2 - EYE_OFFSET_X - EYE_WIDTH / 2;
+  int right_eye_x = SCREEN_WIDTH / 2 + EYE_OFFSET_X - EYE_WIDTH / 2;
+  uint32_t start;
+
+  CycleCounter_Init();
+
+  start = CycleCounter_Read();
+  for (int h = 0; h <= EYE_HEIGHT; h++) {
+    drawEyeRBox(u8g2, left_eye_x, 0, h, 0);
+    drawEyeRBox(u8g2, right_eye_x, 0, h, 0);
+  }
+  *rboxCycles = CycleCounter_Read() - start;
+
+  start = CycleCounter_Read();
+  for (int h = 0; h <= EYE_HEIGHT; h++) {
+    drawEyeSprite(u8g2, left_eye_x, 0, h, 0);
+    drawEyeSprite(u8g2, right_eye_x, 0, h, 0);
+  }
+  *spriteCycles = CycleCounter_Read() - start;
+}
+#endif
+
+// --- Animation Curves ---
+// Tables are generated at compile time, see easing.hpp
+using LookCurve = easing::SineOut;
+
+// --- Expression Timelines ---
+// Stored in flash, see face_timeline.hpp. Tracks start from the pose the
+// expression interrupts.
+static constexpr Keyframe blink_keys[] = {
+    {BLINK_DURATION_MS, 0, Ease::SineIn},
+    {BLINK_DURATION_MS + BLINK_CLOSED_MS, 0, Ease::Step},
+    {BLINK_DURATION_MS + BLINK_CLOSED_MS + BLINK_DURATION_MS, EYE_HEIGHT, Ease::SineOut},
+};
+static constexpr TimelineTrack blink_tracks[] = {TIMELINE_TRACK(TrackTarget::BothHeights, blink_keys)};
+static constexpr Timeline blink_timeline =
+    TIMELINE(blink_tracks, BLINK_DURATION_MS + BLINK_CLOSED_MS + BLINK_DURATION_MS + 1);
+
+static constexpr Keyframe wink_keys[] = {
+    {120, 0, Ease::SineIn},
+    {520, 0, Ease::Step},
+    {680, EYE_HEIGHT, Ease::SineOut},
+};
+static constexpr Keyframe wink_tilt_keys[] = {
+    {120, 4, Ease::SineOut},
+    {520, 4, Ease::Step},
+    {680, 0, Ease::SineInOut},
+};
+// The open eye narrows from the top while the other one is closed
+static constexpr Keyframe wink_lid_keys[] = {
+    {120, 6, Ease::SineOut},
+    {520, 6, Ease::Step},
+    {680, 0, Ease::SineInOut},
+};
+static constexpr TimelineTrack wink_tracks[] = {
+    TIMELINE_TRACK(TrackTarget::RightHeight, wink_keys),
+    TIMELINE_TRACK(TrackTarget::OffsetX, wink_tilt_keys),
+    TIMELINE_TRACK(TrackTarget::LeftLid, wink_lid_keys),
+};
+static constexpr Timeline wink_timeline = TIMELINE(wink_tracks, 700);
+
+// Narrowed eyes with a flat upper lid
+static constexpr Keyframe squint_keys[] = {
+    {150, EYE_HEIGHT * 2 / 3, Ease::CubicOut},
+    {1350, EYE_HEIGHT * 2 / 3, Ease::Step},
+    {1600, EYE_HEIGHT, Ease::Spring},
+};
+static constexpr Keyframe squint_lid_keys[] = {
+    {150, 8, Ease::CubicOut},
+    {1350, 8, Ease::Step},
+    {1600, 0, Ease::SineOut},
+};
+static constexpr TimelineTrack squint_tracks[] = {
+    TIMELINE_TRACK(TrackTarget::BothHeights, squint_keys),
+    TIMELINE_TRACK(TrackTarget::BothLids, squint_lid_keys),
+};
+static constexpr Timeline squint_timeline = TIMELINE(squint_tracks, 1600);
+
+static constexpr Keyframe nod_keys[] = {
+    {150, 6, Ease::SineInOut},
+    {600, 0, Ease::Bounce},
+};
+static constexpr TimelineTrack nod_tracks[] = {TIMELINE_TRACK(TrackTarget::OffsetY, nod_keys)};
+static constexpr Timeline nod_timeline = TIMELINE(nod_tracks, 600);
+
+// Indexed by Face::Expression
+static const Timeline* const expression_timelines[] = {&wink_timeline, &squint_timeline, &nod_timeline};
 
 // --- Animation Base Class Implementation ---
 Animation::Animation(Face* face) : m_face(face) {}
@@ -84,10 +376,23 @@ uint32_t Animation::getElapsedTime(uint32_t currentTime) const {
 }
 
 // --- Face Class Implementation ---
-Face::Face() : m_normalEyes(this), m_blink(this), m_look(this), m_currentAnimation(nullptr), m_nextBlinkTime(0) {}
+Face::Face()
+    : m_normalEyes(this),
+      m_blink(this),
+      m_look(this),
+      m_expression(this),
+      m_currentAnimation(nullptr),
+      m_pendingExpression(nullptr),
+      m_nextBlinkTime(0),
+      m_drawnUntilTime(0),
+      m_isDrawn(false) {}
 
 void Face::init() {
   srand(osKernelGetTickCount());
+  // The face may have run before on another clock (render benchmark), draw it anew
+  m_pendingExpression = nullptr;
+  m_drawnUntilTime = 0;
+  m_isDrawn = false;
   m_currentAnimation = &m_normalEyes;
   m_nextBlinkTime = osKernelGetTickCount() + getRandomInterval(BLINK_INTERVAL_MIN_MS, BLINK_INTERVAL_MAX_MS);
   m_currentAnimation->start(osKernelGetTickCount());
@@ -96,6 +401,17 @@ void Face::init() {
 void Face::update(uint32_t currentTime) {
   if (!m_currentAnimation) return;
 
+  const Timeline* expression = m_pendingExpression;
+  if (expression != nullptr && m_currentAnimation != &m_blink) {
+    m_pendingExpression = nullptr;
+    m_expression.setTimeline(expression);
+    m_currentAnimation = &m_expression;
+    m_currentAnimation->start(currentTime);
+    // The last frame may be held far beyond this, until the next blink or look
+    m_isDrawn = false;
+    return;
+  }
+
   Animation* nextAnimation = m_currentAnimation->update(currentTime);
   if (nextAnimation != m_currentAnimation) {
     Animation* previousAnimation = m_currentAnimation;
@@ -113,9 +429,34 @@ void Face::update(uint32_t currentTime) {
   }
 }
 
-void Face::draw(u8g2_t* u8g2, uint32_t currentTime) {
+void Face::draw(DisplayList_t* list, uint32_t currentTime) {
   if (m_currentAnimation) {
-    m_currentAnimation->draw(u8g2, currentTime);
+    m_currentAnimation->draw(list, currentTime);
+  }
+  m_drawnUntilTime = getNextChangeTime(currentTime);
+  m_isDrawn = true;
+}
+
+bool Face::isAnimating() const { return m_currentAnimation != nullptr && m_currentAnimation != &m_normalEyes; }
+
+uint32_t Face::getNextChangeTime(uint32_t currentTime) const {
+  if (!m_currentAnimation || m_pendingExpression != nullptr) return currentTime;
+
+  uint32_t nextTime = m_currentAnimation->getNextChangeTime(currentTime);
+  // A blink can interrupt any other animation
+  if (m_currentAnimation != &m_blink && isTimeBefore(m_nextBlinkTime, nextTime)) {
+    nextTime = m_nextBlinkTime;
+  }
+  return isTimeBefore(nextTime, currentTime) ? currentTime : nextTime;
+}
+
+bool Face::isDirty(uint32_t currentTime) const {
+  return !m_isDrawn || m_pendingExpression != nullptr || !isTimeBefore(currentTime, m_drawnUntilTime);
+}
+
+void Face::playExpression(Expression expression) {
+  if (expression < Expression::Count) {
+    m_pendingExpression = expression_timelines[(uint8_t)expression];
   }
 }
 
@@ -139,12 +480,14 @@ Animation* NormalEyesAnimation::update(uint32_t currentTime) {
   return this;
 }
 
-void NormalEyesAnimation::draw(u8g2_t* u8g2, uint32_t currentTime) {
-  drawEyes(u8g2, EYE_HEIGHT, get_offset_x(currentTime));
+void NormalEyesAnimation::draw(DisplayList_t* list, uint32_t currentTime) {
+  drawEyes(list, EYE_HEIGHT, get_offset_x(currentTime));
 }
 
 int NormalEyesAnimation::get_offset_x(uint32_t currentTime) const { return 0; }
 
+uint32_t NormalEyesAnimation::getNextChangeTime(uint32_t currentTime) const { return m_nextLookTime; }
+
 // --- BlinkAnimation Implementation ---
 BlinkAnimation::BlinkAnimation(Face* face) : Animation(face) {}
 
@@ -152,68 +495,30 @@ void BlinkAnimation::setReturnAnimation(Animation* anim) { m_returnAnimation = a
 
 void BlinkAnimation::start(uint32_t currentTime) {
   m_startTime = currentTime;
-  m_internalState = CLOSING;
+  m_timeline.start(&blink_timeline, currentTime);
 }
 
 Animation* BlinkAnimation::update(uint32_t currentTime) {
-  uint32_t elapsedTime = getElapsedTime(currentTime);
-  switch (m_internalState) {
-    case CLOSING:
-      if (elapsedTime > BLINK_DURATION_MS) m_internalState = CLOSED;
-      break;
-    case CLOSED:
-      if (elapsedTime > BLINK_DURATION_MS + BLINK_CLOSED_MS) m_internalState = OPENING;
-      break;
-    case OPENING:
-      if (elapsedTime > BLINK_DURATION_MS + BLINK_CLOSED_MS + BLINK_DURATION_MS) {
-        m_face->m_nextBlinkTime = currentTime + getRandomInterval(BLINK_INTERVAL_MIN_MS, BLINK_INTERVAL_MAX_MS);
-        return m_returnAnimation;
-      }
-      break;
+  if (m_timeline.isFinished(currentTime)) {
+    m_face->m_nextBlinkTime = currentTime + getRandomInterval(BLINK_INTERVAL_MIN_MS, BLINK_INTERVAL_MAX_MS);
+    return m_returnAnimation;
   }
   return this;
 }
 
-void BlinkAnimation::draw(u8g2_t* u8g2, uint32_t currentTime) {
-  uint32_t eye_height = EYE_HEIGHT;
-  uint32_t elapsedTime = getElapsedTime(currentTime);
-
-  int current_look_offset = 0;
-  if (m_returnAnimation) {
-    current_look_offset = m_returnAnimation->get_offset_x(currentTime);
-  }
-
-  uint32_t progress;
-
-  switch (m_internalState) {
-    case CLOSING:
-      progress = (elapsedTime * (SINE_LUT_SIZE - 1)) / BLINK_DURATION_MS;
-      if (progress >= SINE_LUT_SIZE) {
-        eye_height = 0;
-      } else {
-        eye_height = (EYE_HEIGHT * sine_lut_q1[SINE_LUT_SIZE - 1 - progress]) / 255;
-      }
-      break;
-    case CLOSED:
-      eye_height = 0;
-      break;
-    case OPENING:
-      elapsedTime -= (BLINK_DURATION_MS + BLINK_CLOSED_MS);
-      progress = (elapsedTime * (SINE_LUT_SIZE - 1)) / BLINK_DURATION_MS;
-      if (progress >= SINE_LUT_SIZE) {
-        eye_height = EYE_HEIGHT;
-      } else {
-        eye_height = (EYE_HEIGHT * sine_lut_q1[progress]) / 255;
-      }
-      break;
-  }
-  drawEyes(u8g2, eye_height, current_look_offset);
+void BlinkAnimation::draw(DisplayList_t* list, uint32_t currentTime) {
+  FacePose base = {EYE_HEIGHT, EYE_HEIGHT, (int16_t)get_offset_x(currentTime), 0};
+  drawPose(list, m_timeline.evaluate(base, currentTime));
 }
 
 int BlinkAnimation::get_offset_x(uint32_t currentTime) const {
   return m_returnAnimation ? m_returnAnimation->get_offset_x(currentTime) : 0;
 }
 
+uint32_t BlinkAnimation::getNextChangeTime(uint32_t currentTime) const {
+  return m_timeline.getNextChangeTime(currentTime);
+}
+
 // --- LookAnimation Implementation ---
 LookAnimation::LookAnimation(Face* face) : Animation(face) {}
 
@@ -239,21 +544,17 @@ Animation* LookAnimation::update(uint32_t currentTime) {
   return this;
 }
 
-void LookAnimation::draw(u8g2_t* u8g2, uint32_t currentTime) { drawEyes(u8g2, EYE_HEIGHT, get_offset_x(currentTime)); }
+void LookAnimation::draw(DisplayList_t* list, uint32_t currentTime) { drawEyes(list, EYE_HEIGHT, get_offset_x(currentTime)); }
 
 void LookAnimation::pause(uint32_t currentTime) { Animation::pause(currentTime); }
 void LookAnimation::resume(uint32_t currentTime) { Animation::resume(currentTime); }
 
 int LookAnimation::get_offset_x(uint32_t currentTime) const {
   uint32_t elapsed = getElapsedTime(currentTime);
-  int32_t eased_offset;
-  uint32_t progress;
 
   // Transition to target
   if (elapsed <= LOOK_TRANSITION_MS) {
-    progress = (elapsed * (SINE_LUT_SIZE - 1)) / LOOK_TRANSITION_MS;
-    eased_offset = (int32_t)((m_target_offset_x - m_start_offset_x) * sine_lut_q1[progress]) / 255;
-    return m_start_offset_x + eased_offset;
+    return easing::lerpFor<LookCurve, LOOK_TRANSITION_MS>(m_start_offset_x, m_target_offset_x, elapsed);
   }
   // Hold at target
   if (elapsed <= m_holdUntilTime) {
@@ -262,11 +563,52 @@ int LookAnimation::get_offset_x(uint32_t currentTime) const {
   // Transition back to center
   uint32_t return_elapsed = elapsed - m_holdUntilTime;
   if (return_elapsed <= LOOK_TRANSITION_MS) {
-    progress = (return_elapsed * (SINE_LUT_SIZE - 1)) / LOOK_TRANSITION_MS;
-    eased_offset = (int32_t)(m_target_offset_x * sine_lut_q1[progress]) / 255;
-    return m_target_offset_x - eased_offset;
+    return easing::lerpFor<LookCurve, LOOK_TRANSITION_MS>(m_target_offset_x, 0, return_elapsed);
   }
 
   // After transition back
   return 0;
 }
+
+uint32_t LookAnimation::getNextChangeTime(uint32_t currentTime) const {
+  uint32_t elapsed = getElapsedTime(currentTime);
+  if (elapsed <= LOOK_TRANSITION_MS || elapsed > m_holdUntilTime) {
+    return currentTime;
+  }
+  // Holding: the image changes when the return transition starts or when
+  // update() switches back to the resting eyes, whichever comes first
+  uint32_t returnTime = currentTime + (m_holdUntilTime - elapsed) + 1;
+  uint32_t switchTime = m_holdUntilTime + LOOK_TRANSITION_MS;
+  return isTimeBefore(switchTime, returnTime) ? switchTime : returnTime;
+}
+
+// --- ExpressionAnimation Implementation ---
+ExpressionAnimation::ExpressionAnimation(Face* face) : Animation(face) {}
+
+void ExpressionAnimation::setTimeline(const Timeline* timeline) { m_source = timeline; }
+
+void ExpressionAnimation::start(uint32_t currentTime) {
+  m_startTime = currentTime;
+  m_timeline.start(m_source, currentTime);
+}
+
+Animation* ExpressionAnimation::update(uint32_t currentTime) {
+  if (m_timeline.isFinished(currentTime)) {
+    return &m_face->m_normalEyes;
+  }
+  return this;
+}
+
+void ExpressionAnimation::draw(DisplayList_t* list, uint32_t currentTime) {
+  FacePose base = {EYE_HEIGHT, EYE_HEIGHT, 0, 0};
+  drawPose(list, m_timeline.evaluate(base, currentTime));
+}
+
+int ExpressionAnimation::get_offset_x(uint32_t currentTime) const {
+  FacePose base = {EYE_HEIGHT, EYE_HEIGHT, 0, 0};
+  return m_timeline.evaluate(base, currentTime).offsetX;
+}
+
+uint32_t ExpressionAnimation::getNextChangeTime(uint32_t currentTime) const {
+  return m_timeline.getNextChangeTime(currentTime);
+}
@@ -0,0 +1,121 @@
+#include "face_timeline.hpp"
+
+#include "easing.hpp"
+
+// Curve value at pos (Q8 units of table entries), the curve is picked per segment
+static int32_t sampleEase(Ease ease, uint32_t pos) {
+  switch (ease) {
+    case Ease::Step:
+      return 0;
+    case Ease::Linear:
+      return easing::sample<easing::Linear>(pos);
+    case Ease::SineIn:
+      return easing::sample<easing::SineIn>(pos);
+    case Ease::SineOut:
+      return easing::sample<easing::SineOut>(pos);
+    case Ease::SineInOut:
+      return easing::sample<easing::SineInOut>(pos);
+    case Ease::CubicIn:
+      return easing::sample<easing::CubicIn>(pos);
+    case Ease::CubicOut:
+      return easing::sample<easing::CubicOut>(pos);
+    case Ease::CubicInOut:
+      return easing::sample<easing::CubicInOut>(pos);
+    case Ease::Spring:
+      return easing::sample<easing::Spring>(pos);
+    case Ease::Bounce:
+      return easing::sample<easing::Bounce>(pos);
+  }
+  return EASING_ONE;
+}
+
+static int32_t evaluateTrack(const TimelineTrack& track, uint32_t elapsed, int32_t baseValue) {
+  uint32_t prevTime = 0;
+  int32_t prevValue = baseValue;
+
+  for (uint8_t i = 0; i < track.keyCount; i++) {
+    const Keyframe& key = track.keys[i];
+    if (elapsed < key.timeMs) {
+      uint32_t duration = key.timeMs - prevTime;
+      uint32_t pos = (elapsed - prevTime) * (EASING_RESOLUTION * 256) / duration;
+      return prevValue + (key.value - prevValue) * sampleEase(key.ease, pos) / EASING_ONE;
+    }
+    prevTime = key.timeMs;
+    prevValue = key.value;
+  }
+  return prevValue;
+}
+
+// Elapsed time at which the track may change next, or UINT32_MAX
+static uint32_t trackNextChange(const TimelineTrack& track, uint32_t elapsed) {
+  for (uint8_t i = 0; i < track.keyCount; i++) {
+    const Keyframe& key = track.keys[i];
+    if (elapsed >= key.timeMs) continue;
+
+    // Step segments and segments between equal values hold until the keyframe
+    bool isFlat = key.ease == Ease::Step || (i > 0 && track.keys[i - 1].value == key.value);
+    return isFlat ? key.timeMs : elapsed;
+  }
+  return UINT32_MAX;
+}
+
+void TimelinePlayer::start(const Timeline* timeline, uint32_t currentTime) {
+  m_timeline = timeline;
+  m_startTime = currentTime;
+}
+
+bool TimelinePlayer::isFinished(uint32_t currentTime) const {
+  return m_timeline == nullptr || currentTime - m_startTime >= m_timeline->durationMs;
+}
+
+FacePose TimelinePlayer::evaluate(const FacePose& base, uint32_t currentTime) const {
+  FacePose pose = base;
+  if (m_timeline == nullptr) return pose;
+
+  uint32_t elapsed = currentTime - m_startTime;
+  for (uint8_t i = 0; i < m_timeline->trackCount; i++) {
+    const TimelineTrack& track = m_timeline->tracks[i];
+    switch (track.target) {
+      case TrackTarget::LeftHeight:
+        pose.leftHeight = evaluateTrack(track, elapsed, base.leftHeight);
+        break;
+      case TrackTarget::RightHeight:
+        pose.rightHeight = evaluateTrack(track, elapsed, base.rightHeight);
+        break;
+      case TrackTarget::BothHeights:
+        pose.leftHeight = evaluateTrack(track, elapsed, base.leftHeight);
+        pose.rightHeight = evaluateTrack(track, elapsed, base.rightHeight);
+        break;
+      case TrackTarget::OffsetX:
+        pose.offsetX = evaluateTrack(track, elapsed, base.offsetX);
+        break;
+      case TrackTarget::OffsetY:
+        pose.offsetY = evaluateTrack(track, elapsed, base.offsetY);
+        break;
+      case TrackTarget::LeftLid:
+        pose.leftLid = evaluateTrack(track, elapsed, base.leftLid);
+        break;
+      case TrackTarget::RightLid:
+        pose.rightLid = evaluateTrack(track, elapsed, base.rightLid);
+        break;
+      case TrackTarget::BothLids:
+        pose.leftLid = evaluateTrack(track, elapsed, base.leftLid);
+        pose.rightLid = evaluateTrack(track, elapsed, base.rightLid);
+        break;
+    }
+  }
+  return pose;
+}
+
+uint32_t TimelinePlayer::getNextChangeTime(uint32_t currentTime) const {
+  if (m_timeline == nullptr) return currentTime;
+
+  uint32_t elapsed = currentTime - m_startTime;
+  uint32_t next = m_timeline->durationMs;  // the owner switches away at the end
+  for (uint8_t i = 0; i < m_timeline->trackCount; i++) {
+    uint32_t trackNext = trackNextChange(m_timeline->tracks[i], elapsed);
+    if (trackNext < next) next = trackNext;
+  }
+  if (next <= elapsed) return currentTime;
+  return m_startTime + next;
+}
@@ -30,8 +30,57 @@ void Face_Update(FaceHandle handle, uint32_t currentTime) {
 void Face_Draw(FaceHandle handle, u8g2_t* u8g2, uint32_t currentTime) {
   Face* face = static_cast<Face*>(handle);
   if (face) {
-    face->draw(u8g2, currentTime);
+    // The face only records, draw the frame right away
+    DisplayCommand_t commands[FACE_COMMANDS_MAX];
+    DisplayList_t list;
+    DisplayList_Init(&list, commands, FACE_COMMANDS_MAX);
+    face->draw(&list, currentTime);
+    DisplayList_Replay(&list, u8g2);
   }
 }
 
+void Face_Record(FaceHandle handle, DisplayList_t* list, uint32_t currentTime) {
+  Face* face = static_cast<Face*>(handle);
+  if (face) {
+    face->draw(list, currentTime);
+  }
+}
+
+uint8_t Face_IsAnimating(FaceHandle handle) {
+  Face* face = static_cast<Face*>(handle);
+  if (face) {
+    return face->isAnimating() ? 1 : 0;
+  }
+  return 0;
+}
+
+uint32_t Face_GetNextChangeTime(FaceHandle handle, uint32_t currentTime) {
+  Face* face = static_cast<Face*>(handle);
+  if (face) {
+    return face->getNextChangeTime(currentTime);
+  }
+  return currentTime;
+}
+
+uint8_t Face_IsDirty(FaceHandle handle, uint32_t currentTime) {
+  Face* face = static_cast<Face*>(handle);
+  if (face) {
+    return face->isDirty(currentTime) ? 1 : 0;
+  }
+  return 0;
+}
+
+void Face_PlayExpression(FaceHandle handle, FaceExpression expression) {
+  Face* face = static_cast<Face*>(handle);
+  if (face) {
+    face->playExpression(static_cast<Face::Expression>(expression));
+  }
+}
+
+#ifdef FACE_BENCHMARK
+void Face_BenchmarkEyes(u8g2_t* u8g2, uint32_t* rboxCycles, uint32_t* spriteCycles) {
+  benchmarkEyeDrawing(u8g2, rboxCycles, spriteCycles);
+}
+#endif
+
 }  // extern "C"
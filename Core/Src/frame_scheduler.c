@@ -0,0 +1,91 @@
+#include "frame_scheduler.h"
+
+static uint32_t fps_to_period(uint32_t fps) {
+  uint32_t freq = osKernelGetTickFreq();
+  if (fps == 0 || fps > freq) {
+    return 1;
+  }
+  return freq / fps;
+}
+
+void FrameScheduler_Init(FrameScheduler_t* sched, uint32_t active_fps, uint32_t idle_fps) {
+  sched->thread = osThreadGetId();
+  sched->active_period = fps_to_period(active_fps);
+  sched->idle_period = fps_to_period(idle_fps);
+  sched->is_active = 1;
+  sched->period = sched->active_period;
+  sched->deadline = osKernelGetTickCount() - sched->period;  // first frame is due now
+  sched->frame_count = 0;
+  sched->missed_count = 0;
+  sched->wake_time = 0;
+  sched->has_wake_time = 0;
+}
+
+void FrameScheduler_SetRate(FrameScheduler_t* sched, uint32_t active_fps, uint32_t idle_fps) {
+  sched->active_period = fps_to_period(active_fps);
+  sched->idle_period = fps_to_period(idle_fps);
+}
+
+void FrameScheduler_SetActive(FrameScheduler_t* sched, uint8_t active) {
+  sched->is_active = active ? 1 : 0;
+  sched->has_wake_time = 0;
+}
+
+void FrameScheduler_SetNextChange(FrameScheduler_t* sched, uint32_t tick) {
+  sched->is_active = ((int32_t)(tick - sched->deadline) <= (int32_t)sched->active_period) ? 1 : 0;
+  sched->wake_time = tick;
+  sched->has_wake_time = 1;
+}
+
+uint32_t FrameScheduler_WaitNextFrame(FrameScheduler_t* sched) {
+  uint32_t period = sched->is_active ? sched->active_period : sched->idle_period;
+  uint32_t missed = 0;
+  uint32_t next = sched->deadline + period;
+  uint32_t now = osKernelGetTickCount();
+  int32_t late = (int32_t)(now - next);
+
+  if (!sched->is_active && sched->has_wake_time) {
+    // Sleep until the content changes, this is not a deadline. The following
+    // active frames start a new grid from here.
+    period = 0;
+    next = sched->wake_time;
+    late = (int32_t)(now - next);
+    if (late > 0) {
+      next = now;
+      late = 0;
+    }
+  }
+
+  if (period != sched->period) {
+    // Rate change: start the new grid from the current slot, a slot that is
+    // already over with the new period is not a miss
+    sched->period = period;
+    if (late > 0) {
+      next = now;
+      late = 0;
+    }
+  }
+
+  if (late < 0) {
+    uint32_t flags = osThreadFlagsWait(FRAME_SCHEDULER_WAKE_FLAG, osFlagsWaitAny, (uint32_t)-late);
+    if ((flags & osFlagsError) == 0U) {
+      // Woken before the slot, the frame starts a new phase at the wake time
+      next = osKernelGetTickCount();
+    }
+  } else if (period != 0 && (uint32_t)late >= period) {
+    // The frame before overran whole slots, skip them and keep the phase
+    missed = (uint32_t)late / period;
+    next += missed * period;
+    sched->missed_count += missed;
+  }
+
+  sched->deadline = next;
+  sched->frame_count++;
+  return missed;
+}
+
+void FrameScheduler_Wake(FrameScheduler_t* sched) {
+  if (sched->thread != NULL) {
+    osThreadFlagsSet(sched->thread, FRAME_SCHEDULER_WAKE_FLAG);
+  }
+}
@@ -32,20 +32,44 @@
 #include <string.h>
 
 #include "DHT11.h"
+#include "display_list.h"
 #include "tim.h"
 #include "u8g2.h"
 #include "u8g2_stm32_hal.h"
 #include "usart.h"
 #include "face_wrapper.h"
+#include "frame_scheduler.h"
+#include "log.h"
+#include "monitor.h"
+#include "page_font.h"
+#include "sensor_mailbox.h"
+#include "text_overlay.h"
+#include "timestamp.h"
+#include "trace.h"
+#ifdef FACE_BENCHMARK
+#include "render_bench.h"
+#endif
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
+typedef StaticTask_t osStaticThreadDef_t;
+typedef StaticSemaphore_t osStaticMutexDef_t;
 /* USER CODE BEGIN PTD */
 
 /* USER CODE END PTD */
 
 /* Private define ------------------------------------------------------------*/
 /* USER CODE BEGIN PD */
+#define DISPLAY_ACTIVE_FPS 50  // while an animation is running
+#define DISPLAY_IDLE_FPS 2     // resting eyes, nothing moves
+#define SENSOR_PERIOD_MS 2000  // the DHT11 needs at least 1 s between readings
+#define SENSOR_OVERLAY_X 68     // temperature and humidity, bottom right below the eyes
+#define SENSOR_OVERLAY_PAGE 7
+#define SENSOR_OVERLAY_WIDTH 60
+#define SENSOR_OVERLAY_CHARSET "0123456789.-C% "  // pre-decoded, everything FormatReading writes
+#define SENSOR_GLYPH_BYTES 5                      // u8g2_font_5x7_tr, at most 5 columns of one page
+#define DISPLAY_COMMANDS_MAX (FACE_COMMANDS_MAX + 1)  // the eyes and the sensor overlay
+#define DISPLAY_PAGE_BYTES 128                         // one page of 128 columns, the buffer of a *_1 setup
 
 /* USER CODE END PD */
 
@@ -56,42 +80,70 @@
 
 /* Private variables ---------------------------------------------------------*/
 /* USER CODE BEGIN Variables */
-static u8g2_t u8g2;
+static u8g2_t u8g2;  // page buffer, frames are recorded into displayList and rendered page by page
+static DisplayCommand_t displayCommands[DISPLAY_COMMANDS_MAX];
+static DisplayList_t displayList;
+static uint8_t displayPageBuffer[DISPLAY_PAGE_BYTES];  // rasterized while the page buffer of u8g2 is sent, and back
+FrameScheduler_t displayFrameScheduler;  // frame rates can be changed at runtime with FrameScheduler_SetRate
+static SensorMailbox_t sensorMailbox;    // latest DHT11 reading, written by sensorTask
+static TextOverlay_t sensorOverlay;
+static uint8_t sensorOverlayBitmap[SENSOR_OVERLAY_WIDTH];
+static PageFont_t sensorPageFont;
+static PageGlyph_t sensorPageGlyphs[sizeof(SENSOR_OVERLAY_CHARSET) - 1];
+static uint8_t sensorPageBitmap[(sizeof(SENSOR_OVERLAY_CHARSET) - 1) * SENSOR_GLYPH_BYTES];
 /* USER CODE END Variables */
 /* Definitions for ledTask */
 osThreadId_t ledTaskHandle;
+uint32_t ledTaskBuffer[ 128 ];
+osStaticThreadDef_t ledTaskControlBlock;
 const osThreadAttr_t ledTask_attributes = {
   .name = "ledTask",
-  .stack_size = 128 * 4,
+  .cb_mem = &ledTaskControlBlock,
+  .cb_size = sizeof(ledTaskControlBlock),
+  .stack_mem = &ledTaskBuffer[0],
+  .stack_size = sizeof(ledTaskBuffer),
   .priority = (osPriority_t) osPriorityNormal,
 };
 /* Definitions for sensorTask */
 osThreadId_t sensorTaskHandle;
+uint32_t sensorTaskBuffer[ 256 ];
+osStaticThreadDef_t sensorTaskControlBlock;
 const osThreadAttr_t sensorTask_attributes = {
   .name = "sensorTask",
-  .stack_size = 256 * 4,
+  .cb_mem = &sensorTaskControlBlock,
+  .cb_size = sizeof(sensorTaskControlBlock),
+  .stack_mem = &sensorTaskBuffer[0],
+  .stack_size = sizeof(sensorTaskBuffer),
   .priority = (osPriority_t) osPriorityNormal,
 };
 /* Definitions for displayTask */
 osThreadId_t displayTaskHandle;
+uint32_t displayTaskBuffer[ 256 ];
+osStaticThreadDef_t displayTaskControlBlock;
 const osThreadAttr_t displayTask_attributes = {
   .name = "displayTask",
-  .stack_size = 256 * 4,
+  .cb_mem = &displayTaskControlBlock,
+  .cb_size = sizeof(displayTaskControlBlock),
+  .stack_mem = &displayTaskBuffer[0],
+  .stack_size = sizeof(displayTaskBuffer),
   .priority = (osPriority_t) osPriorityBelowNormal,
 };
-/* Definitions for sensorDataQueue */
-osMessageQueueId_t sensorDataQueueHandle;
-const osMessageQueueAttr_t sensorDataQueue_attributes = {
-  .name = "sensorDataQueue"
-};
 /* Definitions for screenUpdateMutex */
 osMutexId_t screenUpdateMutexHandle;
+osStaticMutexDef_t screenUpdateMutexControlBlock;
 const osMutexAttr_t screenUpdateMutex_attributes = {
-  .name = "screenUpdateMutex"
+  .name = "screenUpdateMutex",
+  .cb_mem = &screenUpdateMutexControlBlock,
+  .cb_size = sizeof(screenUpdateMutexControlBlock),
 };
 
 /* Private function prototypes -----------------------------------------------*/
 /* USER CODE BEGIN FunctionPrototypes */
+#ifdef FACE_BENCHMARK
+static void EmitBenchLine(const char* line);
+#endif
+static void FormatReading(char* text, size_t size, const SensorReading_t* reading);
+static uint8_t WaitDisplayTiles(uint32_t fence);
 
 /* USER CODE END FunctionPrototypes */
 
@@ -108,7 +160,7 @@ void MX_FREERTOS_Init(void); /* (MISRA C 2004 rule 8.1) */
   */
 void MX_FREERTOS_Init(void) {
   /* USER CODE BEGIN Init */
-  UART_Printf(&huart1, "[USER] STM32 USART1 is working!\r\n");
+  Log_Printf("[USER] STM32 USART1 is working!\r\n");
   /* USER CODE END Init */
   /* Create the mutex(es) */
   /* creation of screenUpdateMutex */
@@ -126,10 +178,6 @@ void MX_FREERTOS_Init(void) {
   /* start timers, add new ones, ... */
   /* USER CODE END RTOS_TIMERS */
 
-  /* Create the queue(s) */
-  /* creation of sensorDataQueue */
-  sensorDataQueueHandle = osMessageQueueNew (1, 8, &sensorDataQueue_attributes);
-
   /* USER CODE BEGIN RTOS_QUEUES */
   /* add queues, ... */
   /* USER CODE END RTOS_QUEUES */
@@ -146,6 +194,8 @@ void MX_FREERTOS_Init(void) {
 
   /* USER CODE BEGIN RTOS_THREADS */
   /* add threads, ... */
+  Monitor_WatchDisplayList(&displayList);
+  Monitor_Init();
   /* USER CODE END RTOS_THREADS */
 
   /* USER CODE BEGIN RTOS_EVENTS */
@@ -184,23 +234,29 @@ void StartSensorTask(void *argument)
 {
   /* USER CODE BEGIN StartSensorTask */
   DHT11_InitTypeDef dht;
-  HAL_DHT11_Init(&dht, DHT11_GPIO_Port, DHT11_Pin, &htim2);
-  DHT11_DATA_S sensorData;
+  HAL_DHT11_InitCapture(&dht, DHT11_GPIO_Port, DHT11_Pin, &htim2, TIM_CHANNEL_2);
+  SensorReading_t reading;
   DHT11_StatusTypeDef ret;
+  uint32_t wake = osKernelGetTickCount();
 
   /* Infinite loop */
   for (;;) {
+    reading.timestamp = Timestamp_Micros();
     ret = HAL_DHT11_ReadData(&dht);
     if (ret == DHT11_OK) {
-      sensorData.humidity = dht.Humidity;
-      sensorData.temperature = dht.Temperature;
+      reading.temperature = (int16_t)lroundf(dht.Temperature * 10.0f);
+      reading.humidity = (uint16_t)lroundf(dht.Humidity * 10.0f);
 
-      osMessageQueuePut(sensorDataQueueHandle, &sensorData, 0U, 0U);
+      // The display task may be asleep until its next blink, only a new value is worth a frame
+      if (SensorMailbox_Publish(&sensorMailbox, &reading)) {
+        FrameScheduler_Wake(&displayFrameScheduler);
+      }
     } else {
-      UART_Printf(&huart1, "[USER] read data from DHT11 failed, ret %u\r\n", ret);
+      TRACE("[USER] read data from DHT11 failed, ret %u", ret);
     }
 
-    osDelay(2000);
+    wake += SENSOR_PERIOD_MS;
+    osDelayUntil(wake);
   }
 
   HAL_DHT11_DeInit(&dht);
@@ -217,45 +273,99 @@ void StartSensorTask(void *argument)
 void StartDisplayTask(void *argument)
 {
   /* USER CODE BEGIN StartDisplayTask */
-  DHT11_DATA_S receivedData = {0};
-  osStatus_t status;
-
+  SensorReading_t reading = {0};
+  uint32_t readingVersion = 0;
+  char sensorText[TEXT_OVERLAY_TEXT_MAX] = "";
+  uint8_t isTextPending = 0;
+
+#ifdef FACE_BENCHMARK
+  // Runs on the face singleton, so before the face is initialized for real.
+  // The cases draw into a full buffer, only benchmark builds link one.
   u8g2_Setup_sh1106_i2c_128x64_noname_f_hal(&u8g2, U8G2_R0);
+  RenderBench_Run(&u8g2, EmitBenchLine);
+#endif
+
+  u8g2_Setup_sh1106_i2c_128x64_noname_1_hal(&u8g2, U8G2_R0);
   u8g2_InitDisplay(&u8g2);
   u8g2_SetPowerSave(&u8g2, 0);
+  // Pages are queued to the I2C DMA stream, the next page is rendered while one is sent
+  static const DisplayTransport_t displayTransport = {u8g2_SendTilesAsync_sh1106_dma, WaitDisplayTiles};
+  DisplayList_Init(&displayList, displayCommands, DISPLAY_COMMANDS_MAX);
+  DisplayList_SetTransport(&displayList, &u8g2, &displayTransport, displayPageBuffer);
 
   FaceHandle myFace = Face_Create();
   Face_Init(myFace);
+  TextOverlay_Init(&sensorOverlay, sensorOverlayBitmap, SENSOR_OVERLAY_X, SENSOR_OVERLAY_PAGE, SENSOR_OVERLAY_WIDTH, 1,
+                   u8g2_font_5x7_tr);
+  if (PageFont_Init(&sensorPageFont, &u8g2, u8g2_font_5x7_tr, SENSOR_OVERLAY_CHARSET, sensorPageGlyphs,
+                    sensorPageBitmap, sizeof(sensorPageBitmap)) > 0) {
+    TextOverlay_SetPageFont(&sensorOverlay, &sensorPageFont);
+  } else {
+    Log_Printf("[USER] [WARN] Sensor glyphs not pre-decoded, drawn by u8g2\r\n");
+  }
 
-  UART_Printf(&huart1, "[USER] SH1106 display initialized\r\n");
-
-  const uint32_t FRAME_RATE = 20;
-  const uint32_t FRAME_PERIOD_MS = 1000 / FRAME_RATE;
+  Log_Printf("[USER] SH1106 display initialized\r\n");
 
-  uint32_t lastWakeTime = osKernelGetTickCount();
+  FrameScheduler_Init(&displayFrameScheduler, DISPLAY_ACTIVE_FPS, DISPLAY_IDLE_FPS);
 
   /* Infinite loop */
   for (;;) {
-    // Wait until the next frame time
-    osDelayUntil(lastWakeTime + FRAME_PERIOD_MS);
-    lastWakeTime = osKernelGetTickCount();
-
-    uint32_t currentTime = lastWakeTime;
+    // Wait for the next frame slot, slots stay on a fixed phase
+    uint32_t missed = FrameScheduler_WaitNextFrame(&displayFrameScheduler);
+    if (missed > 0) {
+      TRACE("[USER] [WARN] Missed %lu frame deadline(s), total %lu", missed,
+            FrameScheduler_GetMissedCount(&displayFrameScheduler));
+    }
 
-    status = osMessageQueueGet(sensorDataQueueHandle, &receivedData, NULL, 0);
-    if (status == osOK) {  // do nothing for now
+    uint32_t currentTime = osKernelGetTickCount();
+
+    int16_t lastTemperature = reading.temperature;
+    if (SensorMailbox_Read(&sensorMailbox, &reading, &readingVersion)) {
+      // Frown at rising, wink at falling temperature, nod at a new humidity
+      if (readingVersion == 1 || reading.temperature == lastTemperature) {
+        Face_PlayExpression(myFace, FACE_EXPRESSION_NOD);
+      } else {
+        Face_PlayExpression(myFace, reading.temperature > lastTemperature ? FACE_EXPRESSION_SQUINT
+                                                                          : FACE_EXPRESSION_WINK);
+      }
+      TRACE("[USER] %d.%u C %u.%u %%RH, %lu us after the measurement", reading.temperature / 10,
+            abs(reading.temperature % 10), reading.humidity / 10, reading.humidity % 10,
+            Timestamp_Micros() - reading.timestamp);
+      FormatReading(sensorText, sizeof(sensorText), &reading);
+      isTextPending = 1;
     }
 
     Face_Update(myFace, currentTime);
 
-    if (osMutexAcquire(screenUpdateMutexHandle, 10) == osOK) {
-      u8g2_ClearBuffer(&u8g2);
-      Face_Draw(myFace, &u8g2, currentTime);
-      u8g2_SendBuffer(&u8g2);
+    // Render and send only when something on screen may have changed
+    if (Face_IsDirty(myFace, currentTime) || isTextPending) {
+      if (osMutexAcquire(screenUpdateMutexHandle, 10) == osOK) {
+        DisplayList_Clear(&displayList);
+        Face_Record(myFace, &displayList, currentTime);
+        // The font is only decoded when the text changed, in the page buffer,
+        // which may still be sent from the last frame
+        if (isTextPending) {
+          DisplayList_Sync(&displayList, &u8g2);
+          TextOverlay_SetText(&sensorOverlay, &u8g2, sensorText);
+          isTextPending = 0;
+        }
+        TextOverlay_Record(&sensorOverlay, &displayList);
+        // Every page is rasterized from the commands that touch it, pages
+        // with the same commands as in the last frame are not sent
+        DisplayList_Render(&displayList, &u8g2);
+
+        (void)osMutexRelease(screenUpdateMutexHandle);
+      } else {
+        TRACE("[USER] [WARN] Skip frame, mutex busy.");
+      }
+    }
 
-      (void)osMutexRelease(screenUpdateMutexHandle);
+    // Sleep until the next blink or look unless the face is moving, a new
+    // sensor reading wakes the task early. A skipped frame stays dirty.
+    if (Face_IsDirty(myFace, currentTime) || isTextPending) {
+      FrameScheduler_SetNextChange(&displayFrameScheduler, currentTime);
     } else {
-      UART_Printf(&huart1, "[USER] [WARN] Skip frame, mutex busy.\r\n");
+      FrameScheduler_SetNextChange(&displayFrameScheduler, Face_GetNextChangeTime(myFace, currentTime));
     }
   }
   /* USER CODE END StartDisplayTask */
@@ -263,6 +373,18 @@ void StartDisplayTask(void *argument)
 
 /* Private application code --------------------------------------------------*/
 /* USER CODE BEGIN Application */
+#ifdef FACE_BENCHMARK
+static void EmitBenchLine(const char* line) { Log_Printf("[BENCH] %s\r\n", line); }
+#endif
+
+// "23.0C 45%", temperature and humidity are in tenths
+static void FormatReading(char* text, size_t size, const SensorReading_t* reading) {
+  int16_t t = reading->temperature;
+  snprintf(text, size, "%s%d.%dC %u%%", t < 0 ? "-" : "", abs(t) / 10, abs(t) % 10,
+           (reading->humidity + 5) / 10);
+}
+
+static uint8_t WaitDisplayTiles(uint32_t fence) { return u8g2_WaitFence_sh1106_dma(fence, osWaitForever); }
 
 /* USER CODE END Application */
 
@@ -0,0 +1,129 @@
+#include "log.h"
+
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+
+#define LOG_RING_MASK (LOG_RING_SIZE - 1)
+
+_Static_assert((LOG_RING_SIZE & LOG_RING_MASK) == 0, "LOG_RING_SIZE must be a power of two");
+
+// Free-running byte indices, the ring position is index & LOG_RING_MASK.
+// reserved: end of the space handed out to writers
+// committed: bytes written so far, equals reserved when no write is in progress
+// sent: end of the data the UART is done with
+static uint8_t log_ring[LOG_RING_SIZE];
+static _Atomic uint32_t log_reserved;
+static _Atomic uint32_t log_committed;
+static _Atomic uint32_t log_sent;
+static _Atomic uint32_t log_drops;
+static atomic_flag log_tx_busy = ATOMIC_FLAG_INIT;
+
+static UART_HandleTypeDef* log_uart;
+static uint16_t log_tx_len;  // length of the transfer in flight
+
+// All written data is complete and some of it is not sent yet. committed is
+// read before reserved: when both are equal no write was in progress at the
+// first load, so everything below committed is in the ring.
+static uint8_t log_is_ready(uint32_t* committed) {
+  uint32_t c = atomic_load(&log_committed);
+  uint32_t r = atomic_load(&log_reserved);
+  *committed = c;
+  return c == r && c != atomic_load(&log_sent);
+}
+
+// Start a transfer if the UART is idle and there is data to send
+static void log_kick(void) {
+  if (log_uart == NULL) return;
+
+  while (!atomic_flag_test_and_set(&log_tx_busy)) {
+    uint32_t committed;
+    if (log_is_ready(&committed)) {
+      uint32_t sent = atomic_load(&log_sent);
+      uint32_t pos = sent & LOG_RING_MASK;
+      uint32_t len = committed - sent;
+      if (len > LOG_RING_SIZE - pos) len = LOG_RING_SIZE - pos;
+
+      log_tx_len = len;
+      if (HAL_UART_Transmit_DMA(log_uart, &log_ring[pos], len) != HAL_OK) {
+        log_tx_len = 0;
+        atomic_flag_clear(&log_tx_busy);
+      }
+      return;
+    }
+    atomic_flag_clear(&log_tx_busy);
+
+    // A write completing before the clear saw the UART busy and left the kick to us
+    if (!log_is_ready(&committed)) return;
+  }
+}
+
+void Log_Init(UART_HandleTypeDef* huart) {
+  log_uart = huart;
+  log_kick();
+}
+
+uint8_t Log_Write(const void* data, size_t len) {
+  if (len == 0) return 1;
+  if (len > LOG_RING_SIZE) {
+    atomic_fetch_add(&log_drops, 1);
+    return 0;
+  }
+
+  // Reserve [start, start + len) if the UART has freed enough of the ring
+  uint32_t start = atomic_load(&log_reserved);
+  do {
+    if (start + len - atomic_load(&log_sent) > LOG_RING_SIZE) {
+      atomic_fetch_add(&log_drops, 1);
+      return 0;
+    }
+  } while (!atomic_compare_exchange_weak(&log_reserved, &start, start + len));
+
+  uint32_t pos = start & LOG_RING_MASK;
+  uint32_t first = LOG_RING_SIZE - pos;
+  if (first >= len) {
+    memcpy(&log_ring[pos], data, len);
+  } else {
+    memcpy(&log_ring[pos], data, first);
+    memcpy(log_ring, (const uint8_t*)data + first, len - first);
+  }
+
+  atomic_fetch_add(&log_committed, len);
+  log_kick();
+  return 1;
+}
+
+void Log_Printf(const char* fmt, ...) {
+  char line[LOG_LINE_MAX];
+
+  va_list args;
+  va_start(args, fmt);
+  int len = vsnprintf(line, sizeof(line), fmt, args);
+  va_end(args);
+
+  if (len <= 0) return;
+  if (len >= (int)sizeof(line)) len = sizeof(line) - 1;
+  Log_Write(line, len);
+}
+
+uint32_t Log_GetDropCount(void) { return atomic_load(&log_drops); }
+
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef* huart) {
+  if (huart != log_uart) return;
+
+  atomic_fetch_add(&log_sent, log_tx_len);
+  log_tx_len = 0;
+  atomic_flag_clear(&log_tx_busy);
+  log_kick();
+}
+
+void HAL_UART_ErrorCallback(UART_HandleTypeDef* huart) {
+  if (huart != log_uart) return;
+
+  // The HAL has stopped the transfer, skip its data so the ring does not stay full
+  atomic_fetch_add(&log_sent, log_tx_len);
+  log_tx_len = 0;
+  atomic_flag_clear(&log_tx_busy);
+  log_kick();
+}
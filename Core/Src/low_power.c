@@ -0,0 +1,249 @@
+#include "low_power.h"
+
+#include "FreeRTOS.h"
+#include "i2c.h"
+#include "task.h"
+#include "tim.h"
+#include "timestamp.h"
+#include "usart.h"
+
+#define LOW_POWER_RTC_PRESCALER 4     // RTC counter at LSI / 4, about 100 us per count
+#define LOW_POWER_LSI_MIN_HZ 30000      // datasheet minimum, wakes early rather than late until calibrated
+#define LOW_POWER_MAX_IDLE_MS 60000     // keeps the microsecond arithmetic in 32 bits
+#define LOW_POWER_US_PER_TICK (1000000U / configTICK_RATE_HZ)
+#define LOW_POWER_US_PER_HAL_TICK 1000U  // TIM4 counts microseconds up to its update every millisecond
+
+extern TIM_HandleTypeDef htim4;  // HAL timebase, stm32f1xx_hal_timebase_tim.c
+
+static LowPowerStats_t low_power_stats;
+static uint32_t low_power_rtc_hz = LOW_POWER_LSI_MIN_HZ / LOW_POWER_RTC_PRESCALER;
+
+// SLEEP periods measured on both clocks, for the next calibration
+static uint32_t low_power_cal_counts;
+static uint32_t low_power_cal_us;
+
+// --- RTC, see RM0008 "Real-time clock" for the register access rules ---
+
+static void low_power_rtc_sync(void) {
+  // After STOP the APB1 side of the RTC registers is stale until the next RTC clock edge
+  RTC->CRL &= ~RTC_CRL_RSF;
+  while ((RTC->CRL & RTC_CRL_RSF) == 0) {
+  }
+}
+
+// A write to the RTC takes up to three RTC clock cycles, about 100 us on the LSI
+static void low_power_rtc_wait_write(void) {
+  while ((RTC->CRL & RTC_CRL_RTOFF) == 0) {
+  }
+}
+
+static void low_power_rtc_enter_config(void) {
+  low_power_rtc_wait_write();
+  RTC->CRL |= RTC_CRL_CNF;
+}
+
+// The write completes in the background, less than one count at LOW_POWER_RTC_PRESCALER
+static void low_power_rtc_exit_config(void) {
+  RTC->CRL &= ~RTC_CRL_CNF;
+}
+
+static uint32_t low_power_rtc_counter(void) {
+  uint32_t high, low;
+  do {
+    high = RTC->CNTH;
+    low = RTC->CNTL;
+  } while (high != RTC->CNTH);
+  return (high << 16) | low;
+}
+
+static void low_power_rtc_set_alarm(uint32_t count) {
+  // Cleared first, the RTC ignores writes until the alarm write below has completed
+  RTC->CRL &= ~RTC_CRL_ALRF;
+  EXTI->PR = EXTI_PR_PR17;
+
+  low_power_rtc_enter_config();
+  RTC->ALRH = count >> 16;
+  RTC->ALRL = count & 0xFFFFU;
+  low_power_rtc_exit_config();
+}
+
+// --- STOP ---
+
+static int low_power_stop_allowed(TickType_t idle) {
+  if (low_power_stats.rtc_hz == 0 || idle < pdMS_TO_TICKS(LOW_POWER_STOP_MIN_MS)) return 0;
+
+  // STOP halts the peripheral clocks, a transfer in flight would be cut
+  if (HAL_I2C_GetState(&hi2c1) != HAL_I2C_STATE_READY) return 0;
+  if (HAL_UART_GetState(&huart1) != HAL_UART_STATE_READY) return 0;
+  if (HAL_UART_GetState(&huart2) != HAL_UART_STATE_READY) return 0;
+  if (HAL_TIM_GetChannelState(&htim2, TIM_CHANNEL_2) != HAL_TIM_CHANNEL_STATE_READY) return 0;
+  return 1;
+}
+
+// STOP leaves the core on the HSI, bring back the HSE and the PLL of SystemClock_Config()
+static void low_power_restore_clock(void) {
+  __HAL_RCC_HSE_CONFIG(RCC_HSE_ON);
+  while (__HAL_RCC_GET_FLAG(RCC_FLAG_HSERDY) == RESET) {
+  }
+  __HAL_RCC_PLL_ENABLE();
+  while (__HAL_RCC_GET_FLAG(RCC_FLAG_PLLRDY) == RESET) {
+  }
+  __HAL_RCC_SYSCLK_CONFIG(RCC_SYSCLKSOURCE_PLLCLK);
+  while (__HAL_RCC_GET_SYSCLK_SOURCE() != RCC_SYSCLKSOURCE_STATUS_PLLCLK) {
+  }
+}
+
+// Sleep in STOP until us after start_us, returns the microseconds since start_us
+static uint32_t low_power_stop(uint32_t start_us, uint32_t us) {
+  // Start on a counter edge, so the count slept is exact to the wake up side
+  uint32_t start = low_power_rtc_counter();
+  while (low_power_rtc_counter() == start) {
+  }
+  start++;
+  uint32_t edge_us = Timestamp_Micros() - start_us;
+
+  uint32_t counts = (uint32_t)((uint64_t)(us - edge_us - LOW_POWER_STOP_WAKE_US) * low_power_rtc_hz / 1000000U);
+  low_power_rtc_set_alarm(start + counts);
+  HAL_PWR_EnterSTOPMode(PWR_LOWPOWERREGULATOR_ON, PWR_STOPENTRY_WFI);
+
+  low_power_restore_clock();
+  low_power_rtc_sync();
+
+  // The wake up is somewhere in the current count, take the middle
+  uint32_t slept = low_power_rtc_counter() - start;
+  return edge_us + (uint32_t)(((uint64_t)slept * 2 + 1) * 1000000U / (2 * low_power_rtc_hz));
+}
+
+// --- SLEEP ---
+
+static void low_power_sleep(uint32_t us) {
+  uint32_t start = low_power_rtc_counter();
+  uint32_t start_us = Timestamp_Micros();
+  uint32_t counts = (uint32_t)((uint64_t)us * low_power_rtc_hz / 1000000U);
+  low_power_rtc_set_alarm(start + (counts ? counts : 1));
+
+  __DSB();
+  __WFI();
+
+  // Both clocks ran, measure the LSI against TIM3
+  low_power_cal_counts += low_power_rtc_counter() - start;
+  low_power_cal_us += Timestamp_Micros() - start_us;
+  if (low_power_cal_us >= LOW_POWER_CALIBRATION_US) {
+    low_power_rtc_hz = (uint32_t)((uint64_t)low_power_cal_counts * 1000000U / low_power_cal_us);
+    low_power_stats.rtc_hz = low_power_rtc_hz;
+    low_power_cal_counts = 0;
+    low_power_cal_us = 0;
+  }
+}
+
+void vPortSuppressTicksAndSleep(TickType_t xExpectedIdleTime) {
+  const uint32_t cycles_per_us = configCPU_CLOCK_HZ / 1000000U;
+  const uint32_t cycles_per_tick = configCPU_CLOCK_HZ / configTICK_RATE_HZ;
+
+  if (xExpectedIdleTime > pdMS_TO_TICKS(LOW_POWER_MAX_IDLE_MS)) xExpectedIdleTime = pdMS_TO_TICKS(LOW_POWER_MAX_IDLE_MS);
+
+  // The alarm write of the last idle period may still be running, wait for it
+  // while interrupts are served so the alarm is set without waiting below
+  low_power_rtc_wait_write();
+
+  __disable_irq();
+  __DSB();
+  __ISB();
+  if (eTaskConfirmSleepModeStatus() == eAbortSleep) {
+    __enable_irq();
+    return;
+  }
+
+  // Stop both tick sources, the part of the current tick already elapsed counts as idle
+  SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+  HAL_SuspendTick();
+  uint32_t start_us = Timestamp_Micros();
+  uint32_t elapsed_us = (SysTick->LOAD - SysTick->VAL) / cycles_per_us;
+  // Same for the HAL tick, an update already pending is a millisecond not counted yet
+  uint32_t hal_us = __HAL_TIM_GET_COUNTER(&htim4);
+  if (__HAL_TIM_GET_FLAG(&htim4, TIM_FLAG_UPDATE)) hal_us = __HAL_TIM_GET_COUNTER(&htim4) + LOW_POWER_US_PER_HAL_TICK;
+  uint32_t idle_us = xExpectedIdleTime * LOW_POWER_US_PER_TICK - elapsed_us;
+
+  if (low_power_stop_allowed(xExpectedIdleTime)) {
+    uint32_t slept = low_power_stop(start_us, idle_us);
+    Timestamp_Advance(start_us + slept - Timestamp_Micros());
+    low_power_stats.stop_count++;
+    low_power_stats.stop_us += slept;
+  } else {
+    low_power_sleep(idle_us);
+    low_power_stats.sleep_count++;
+    low_power_stats.sleep_us += Timestamp_Micros() - start_us;
+  }
+  uint32_t slept_us = Timestamp_Micros() - start_us;
+  elapsed_us += slept_us;
+  hal_us += slept_us;
+
+  // Whole ticks are stepped, the last due tick and the remainder are left to the SysTick
+  uint32_t ticks = elapsed_us / LOW_POWER_US_PER_TICK;
+  if (ticks > xExpectedIdleTime - 1) ticks = xExpectedIdleTime - 1;
+  uint32_t remainder_us = elapsed_us - ticks * LOW_POWER_US_PER_TICK;
+  if (remainder_us >= LOW_POWER_US_PER_TICK) remainder_us = LOW_POWER_US_PER_TICK - 1;
+  vTaskStepTick(ticks);
+
+  SysTick->LOAD = (LOW_POWER_US_PER_TICK - remainder_us) * cycles_per_us - 1;
+  SysTick->VAL = 0;
+  SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+  SysTick->LOAD = cycles_per_tick - 1;  // from the next period on
+
+  // TIM4 kept counting in SLEEP and stood still in STOP, either way it is set
+  // to the fraction of a millisecond left over. The update it may have flagged
+  // meanwhile is already in the whole milliseconds stepped.
+  uwTick += (hal_us / LOW_POWER_US_PER_HAL_TICK) * uwTickFreq;
+  __HAL_TIM_SET_COUNTER(&htim4, hal_us % LOW_POWER_US_PER_HAL_TICK);
+  __HAL_TIM_CLEAR_FLAG(&htim4, TIM_FLAG_UPDATE);
+  HAL_ResumeTick();
+  __enable_irq();
+}
+
+void LowPower_Init(void) {
+  __HAL_RCC_PWR_CLK_ENABLE();
+  __HAL_RCC_BKP_CLK_ENABLE();
+  HAL_PWR_EnableBkUpAccess();
+
+  __HAL_RCC_LSI_ENABLE();
+  while (__HAL_RCC_GET_FLAG(RCC_FLAG_LSIRDY) == RESET) {
+  }
+  // The backup domain survives a reset, its clock source can only change after a backup reset
+  if (__HAL_RCC_GET_RTC_SOURCE() != RCC_RTCCLKSOURCE_LSI) {
+    __HAL_RCC_BACKUPRESET_FORCE();
+    __HAL_RCC_BACKUPRESET_RELEASE();
+    __HAL_RCC_RTC_CONFIG(RCC_RTCCLKSOURCE_LSI);
+  }
+  __HAL_RCC_RTC_ENABLE();
+  low_power_rtc_sync();
+
+  low_power_rtc_enter_config();
+  RTC->PRLH = 0;
+  RTC->PRLL = LOW_POWER_RTC_PRESCALER - 1;
+  low_power_rtc_exit_config();
+  low_power_rtc_wait_write();
+  RTC->CRH = RTC_CRH_ALRIE;
+
+  // Only EXTI lines wake from STOP, the RTC alarm is line 17
+  EXTI->IMR |= EXTI_IMR_MR17;
+  EXTI->RTSR |= EXTI_RTSR_TR17;
+  HAL_NVIC_SetPriority(RTC_Alarm_IRQn, 5, 0);
+  HAL_NVIC_EnableIRQ(RTC_Alarm_IRQn);
+
+#ifdef DEBUG
+  // Keep the debug connection alive in SLEEP and STOP
+  HAL_DBGMCU_EnableDBGSleepMode();
+  HAL_DBGMCU_EnableDBGStopMode();
+#endif
+}
+
+void LowPower_GetStats(LowPowerStats_t* stats) {
+  taskENTER_CRITICAL();
+  *stats = low_power_stats;
+  taskEXIT_CRITICAL();
+}
+
+void LowPower_AlarmIRQHandler(void) {
+  RTC->CRL &= ~RTC_CRL_ALRF;
+  EXTI->PR = EXTI_PR_PR17;
+}
@@ -27,7 +27,9 @@
 
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
-
+#include "log.h"
+#include "low_power.h"
+#include "timestamp.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -49,10 +51,13 @@
 
 /* USER CODE BEGIN PV */
 osSemaphoreId_t i2cDmaSemaphoreHandle;
+static StaticSemaphore_t i2cDmaSemaphoreControlBlock;
 const osSemaphoreAttr_t i2cDmaSemaphore_attributes = {
-  .name = "i2cDmaSemaphore"
+  .name = "i2cDmaSemaphore",
+  .cb_mem = &i2cDmaSemaphoreControlBlock,
+  .cb_size = sizeof(i2cDmaSemaphoreControlBlock),
 };
-volatile uint32_t g_HighFrequencyTimerTicks = 0;
+volatile uint32_t g_HighFrequencyTimerTicks = 0;  // TIM3 overflows, counted in TIM3_IRQHandler, see timestamp.h
 /* USER CODE END PV */
 
 /* Private function prototypes -----------------------------------------------*/
@@ -103,6 +108,10 @@ int main(void)
   MX_USART2_UART_Init();
   MX_TIM3_Init();
   /* USER CODE BEGIN 2 */
+  Timestamp_Init();
+  LowPower_Init();
+  Log_Init(&huart1);
+
   i2cDmaSemaphoreHandle = osSemaphoreNew(1, 0, &i2cDmaSemaphore_attributes);
   if (i2cDmaSemaphoreHandle == NULL) {
     Error_Handler();
@@ -183,9 +192,7 @@ void SystemClock_Config(void)
 void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
 {
   /* USER CODE BEGIN Callback 0 */
-  if (htim->Instance == TIM3) {
-    g_HighFrequencyTimerTicks++;
-  }
+
   /* USER CODE END Callback 0 */
   if (htim->Instance == TIM4)
   {
@@ -0,0 +1,122 @@
+#include "monitor.h"
+
+#include "FreeRTOS.h"
+#include "log.h"
+#include "low_power.h"
+#include "task.h"
+
+#define MONITOR_STACK_WORDS 192
+
+typedef struct {
+  const char* name;
+  osMessageQueueId_t queue;
+} MonitorQueue_t;
+
+static MonitorQueue_t monitor_queues[MONITOR_MAX_QUEUES];
+static uint32_t monitor_queue_count;
+static const DisplayList_t* monitor_display_list;
+
+// Samples of the previous period, to turn the run-time counters into load
+static TaskStatus_t monitor_tasks[MONITOR_MAX_TASKS];
+static UBaseType_t monitor_prev_number[MONITOR_MAX_TASKS];
+static uint32_t monitor_prev_runtime[MONITOR_MAX_TASKS];
+static uint32_t monitor_prev_count;
+static uint32_t monitor_prev_total;
+static LowPowerStats_t monitor_prev_power;
+static uint32_t monitor_prev_bytes_sent;
+static uint32_t monitor_prev_bytes_skipped;
+
+static StaticTask_t monitor_tcb;
+static StackType_t monitor_stack[MONITOR_STACK_WORDS];
+
+static const osThreadAttr_t monitor_attributes = {
+    .name = "monitorTask",
+    .cb_mem = &monitor_tcb,
+    .cb_size = sizeof(monitor_tcb),
+    .stack_mem = monitor_stack,
+    .stack_size = sizeof(monitor_stack),
+    .priority = (osPriority_t)osPriorityLow,
+};
+
+static uint32_t monitor_prev_runtime_of(UBaseType_t number) {
+  for (uint32_t i = 0; i < monitor_prev_count; i++) {
+    if (monitor_prev_number[i] == number) return monitor_prev_runtime[i];
+  }
+  return 0;  // new task, its whole run time is in this period
+}
+
+static void monitor_report(void) {
+  uint32_t total;
+  UBaseType_t count = uxTaskGetSystemState(monitor_tasks, MONITOR_MAX_TASKS, &total);
+  if (count == 0) {
+    Log_Printf("{\"mon\":\"error\",\"reason\":\"more than %u tasks\"}\r\n", MONITOR_MAX_TASKS);
+    return;
+  }
+  uint32_t elapsed = total - monitor_prev_total;
+
+  Log_Printf("{\"mon\":\"sys\",\"t\":%lu,\"log_drops\":%lu}\r\n", osKernelGetTickCount(), Log_GetDropCount());
+
+  // The run-time counter is the timestamp, the residencies are in the same microseconds
+  LowPowerStats_t power;
+  LowPower_GetStats(&power);
+  uint32_t sleep = elapsed ? (uint32_t)((uint64_t)(power.sleep_us - monitor_prev_power.sleep_us) * 1000 / elapsed) : 0;
+  uint32_t stop = elapsed ? (uint32_t)((uint64_t)(power.stop_us - monitor_prev_power.stop_us) * 1000 / elapsed) : 0;
+  Log_Printf("{\"mon\":\"power\",\"sleep\":%lu.%lu,\"sleep_n\":%lu,\"stop\":%lu.%lu,\"stop_n\":%lu,\"rtc_hz\":%lu}\r\n",
+             sleep / 10, sleep % 10, power.sleep_count - monitor_prev_power.sleep_count, stop / 10, stop % 10,
+             power.stop_count - monitor_prev_power.stop_count, power.rtc_hz);
+  monitor_prev_power = power;
+
+  for (UBaseType_t i = 0; i < count; i++) {
+    const TaskStatus_t* task = &monitor_tasks[i];
+    uint32_t used = task->ulRunTimeCounter - monitor_prev_runtime_of(task->xTaskNumber);
+    // Tenths of a percent, in 64 bits as the counters can be far apart
+    uint32_t load = elapsed ? (uint32_t)((uint64_t)used * 1000 / elapsed) : 0;
+
+    Log_Printf("{\"mon\":\"task\",\"name\":\"%s\",\"prio\":%lu,\"cpu\":%lu.%lu,\"stack_free\":%lu}\r\n",
+               task->pcTaskName, task->uxCurrentPriority, load / 10, load % 10,
+               (uint32_t)(task->usStackHighWaterMark * sizeof(StackType_t)));
+  }
+
+  for (uint32_t i = 0; i < monitor_queue_count; i++) {
+    Log_Printf("{\"mon\":\"queue\",\"name\":\"%s\",\"used\":%lu,\"size\":%lu}\r\n", monitor_queues[i].name,
+               osMessageQueueGetCount(monitor_queues[i].queue), osMessageQueueGetCapacity(monitor_queues[i].queue));
+  }
+
+  if (monitor_display_list != NULL) {
+    // Totals of the display task, each word is read at once
+    uint32_t sent = monitor_display_list->total_bytes_sent;
+    uint32_t skipped = monitor_display_list->total_bytes_skipped;
+    Log_Printf("{\"mon\":\"display\",\"sent\":%lu,\"skipped\":%lu}\r\n", sent - monitor_prev_bytes_sent,
+               skipped - monitor_prev_bytes_skipped);
+    monitor_prev_bytes_sent = sent;
+    monitor_prev_bytes_skipped = skipped;
+  }
+
+  for (UBaseType_t i = 0; i < count; i++) {
+    monitor_prev_number[i] = monitor_tasks[i].xTaskNumber;
+    monitor_prev_runtime[i] = monitor_tasks[i].ulRunTimeCounter;
+  }
+  monitor_prev_count = count;
+  monitor_prev_total = total;
+}
+
+static void monitor_task(void* argument) {
+  uint32_t wake = osKernelGetTickCount();
+
+  for (;;) {
+    wake += MONITOR_PERIOD_MS;
+    osDelayUntil(wake);
+    monitor_report();
+  }
+}
+
+void Monitor_WatchQueue(const char* name, osMessageQueueId_t queue) {
+  if (monitor_queue_count >= MONITOR_MAX_QUEUES) return;
+  monitor_queues[monitor_queue_count].name = name;
+  monitor_queues[monitor_queue_count].queue = queue;
+  monitor_queue_count++;
+}
+
+void Monitor_WatchDisplayList(const DisplayList_t* list) { monitor_display_list = list; }
+
+void Monitor_Init(void) { osThreadNew(monitor_task, NULL, &monitor_attributes); }
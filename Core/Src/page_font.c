@@ -0,0 +1,209 @@
+#include "page_font.h"
+
+#include <string.h>
+
+// Draw the glyph on the cleared cell at the left of the buffer, page by page, with the buffer kept as it was
+static int8_t page_font_rasterize(u8g2_t* u8g2, uint8_t ascent, uint8_t pages, uint16_t encoding,
+                                  uint8_t cell[PAGE_FONT_MAX_PAGES][PAGE_FONT_MAX_WIDTH]) {
+  uint16_t stride = u8g2_GetBufferTileWidth(u8g2) * 8;
+  uint8_t saved[PAGE_FONT_MAX_WIDTH];
+  int8_t advance = 0;
+
+  for (uint8_t p = 0; p < pages; p++) {
+    // A page buffer is moved over the cell
+    if (p < u8g2->tile_curr_row || p >= u8g2->tile_curr_row + u8g2->tile_buf_height) {
+      u8g2_SetBufferCurrTileRow(u8g2, p);
+    }
+    uint8_t* row = u8g2_GetBufferPtr(u8g2) + (uint16_t)(p - u8g2->tile_curr_row) * stride;
+    memcpy(saved, row, PAGE_FONT_MAX_WIDTH);
+    memset(row, 0, PAGE_FONT_MAX_WIDTH);
+    u8g2_SetClipWindow(u8g2, 0, p * 8, PAGE_FONT_MAX_WIDTH, p * 8 + 8);
+    advance = (int8_t)u8g2_DrawGlyph(u8g2, 0, ascent, encoding);
+    memcpy(cell[p], row, PAGE_FONT_MAX_WIDTH);
+    memcpy(row, saved, PAGE_FONT_MAX_WIDTH);
+  }
+  u8g2_SetMaxClipWindow(u8g2);
+  return advance;
+}
+
+// Copy the glyph box out of the rasterized cell, returns 0 if it does not fit
+static uint8_t page_font_store(PageFont_t* page_font, PageGlyph_t* glyph, u8g2_t* u8g2,
+                               uint8_t cell[PAGE_FONT_MAX_PAGES][PAGE_FONT_MAX_WIDTH], uint8_t* bitmap,
+                               uint16_t size, uint16_t* used) {
+  glyph->offset = *used;
+  glyph->x = 0;
+  glyph->width = 0;
+  glyph->top = 0;
+  glyph->height = 0;
+  // u8g2 leaves the origin of the glyph box in the decode state, not for empty glyphs
+  if (u8g2->font_decode.glyph_width == 0) return 1;
+
+  u8g2_uint_t x = u8g2->font_decode.target_x;
+  u8g2_uint_t y = u8g2->font_decode.target_y;
+  uint8_t width = u8g2->font_decode.glyph_width;
+  uint8_t height = u8g2->font_decode.glyph_height;
+  if (x >= PAGE_FONT_MAX_WIDTH || x + width > PAGE_FONT_MAX_WIDTH) return 0;
+  if (y >= page_font->pages * 8 || y + height > page_font->pages * 8) return 0;
+  if (*used + (uint16_t)width * page_font->pages > size) return 0;
+
+  glyph->x = x;
+  glyph->width = width;
+  glyph->top = y;
+  glyph->height = height;
+  for (uint8_t i = 0; i < width; i++) {
+    for (uint8_t p = 0; p < page_font->pages; p++) {
+      bitmap[(*used)++] = cell[p][x + i];
+    }
+  }
+  return 1;
+}
+
+uint16_t PageFont_Init(PageFont_t* page_font, u8g2_t* u8g2, const uint8_t* font, const char* charset,
+                       PageGlyph_t* glyphs, uint8_t* bitmap, uint16_t size) {
+  const uint8_t* saved_font = u8g2->font;
+  u8g2_font_calc_vref_fnptr vref = u8g2->font_calc_vref;
+  uint8_t color = u8g2->draw_color;
+  uint8_t curr_row = u8g2->tile_curr_row;
+  uint16_t used = 0;
+
+  u8g2_SetFont(u8g2, font);
+  u8g2_SetFontPosBaseline(u8g2);
+  u8g2_SetDrawColor(u8g2, 1);
+  page_font->font = font;
+  page_font->charset = charset;
+  page_font->glyphs = glyphs;
+  page_font->bitmap = bitmap;
+  // The cell is the bounding box of the font, y_offset is its descent
+  page_font->pages = (u8g2->font_info.max_char_height + 7) / 8;
+  page_font->ascent = u8g2->font_info.max_char_height + u8g2->font_info.y_offset;
+
+  uint8_t is_valid = page_font->pages <= PAGE_FONT_MAX_PAGES &&
+                     u8g2->font_info.max_char_height + u8g2->font_info.y_offset >= 0 &&
+                     u8g2_GetBufferTileWidth(u8g2) * 8 >= PAGE_FONT_MAX_WIDTH;
+  for (uint8_t i = 0; is_valid && charset[i] != '\0'; i++) {
+    uint8_t c = charset[i];
+    uint8_t cell[PAGE_FONT_MAX_PAGES][PAGE_FONT_MAX_WIDTH];
+    if (!u8g2_IsGlyph(u8g2, c)) {
+      is_valid = 0;
+      break;
+    }
+    glyphs[i].advance = page_font_rasterize(u8g2, page_font->ascent, page_font->pages, c, cell);
+    is_valid = page_font_store(page_font, &glyphs[i], u8g2, cell, bitmap, size, &used);
+  }
+
+  if (u8g2->tile_curr_row != curr_row) {
+    u8g2_SetBufferCurrTileRow(u8g2, curr_row);
+  }
+  // u8g2_SetFont() also reloads the font info
+  if (saved_font != NULL) u8g2_SetFont(u8g2, saved_font);
+  u8g2->font_calc_vref = vref;
+  u8g2->draw_color = color;
+  return is_valid ? used : 0;
+}
+
+static const PageGlyph_t* page_font_find(const PageFont_t* page_font, uint16_t encoding) {
+  for (uint8_t i = 0; page_font->charset[i] != '\0'; i++) {
+    if ((uint8_t)page_font->charset[i] == encoding) return &page_font->glyphs[i];
+  }
+  return NULL;
+}
+
+// Glyphs are blitted for draw colors 0 and 1 into an unrotated vertical_top_lsb buffer
+static uint8_t page_font_is_blittable(const u8g2_t* u8g2) {
+  if (u8g2->ll_hvline != u8g2_ll_hvline_vertical_top_lsb || u8g2->cb != U8G2_R0) return 0;
+#ifdef U8G2_WITH_FONT_ROTATION
+  if (u8g2->font_decode.dir != 0) return 0;
+#endif
+  return u8g2->draw_color < 2;
+}
+
+static u8g2_uint_t page_font_draw_with_u8g2(const PageFont_t* page_font, u8g2_t* u8g2, u8g2_uint_t x, u8g2_uint_t y,
+                                            uint16_t encoding) {
+  const uint8_t* font = u8g2->font;
+  u8g2_font_calc_vref_fnptr vref = u8g2->font_calc_vref;
+  u8g2_SetFont(u8g2, page_font->font);
+  u8g2_SetFontPosBaseline(u8g2);
+  u8g2_uint_t advance = u8g2_DrawGlyph(u8g2, x, y, encoding);
+  if (font != NULL) u8g2_SetFont(u8g2, font);
+  u8g2->font_calc_vref = vref;
+  return advance;
+}
+
+// Glyph box with its left column at x0 and the cell at row top, clipped to the user window of u8g2
+static void page_font_blit(const PageFont_t* page_font, const PageGlyph_t* glyph, u8g2_t* u8g2, int32_t x0,
+                           int32_t top) {
+#ifdef U8G2_WITH_CLIP_WINDOW_SUPPORT
+  // The user window is the buffer window while the clip window is outside of it
+  if (u8g2->is_page_clip_window_intersection == 0) return;
+#endif
+  int32_t x1 = x0 + glyph->width;
+  const uint8_t* src = page_font->bitmap + glyph->offset;
+  if (x0 < u8g2->user_x0) {
+    src += (u8g2->user_x0 - x0) * page_font->pages;
+    x0 = u8g2->user_x0;
+  }
+  if (x1 > u8g2->user_x1) x1 = u8g2->user_x1;
+  if (x0 >= x1) return;
+
+  // Rows of the glyph box from the top of the page the cell starts in, within
+  // the user window, which lies within the buffer window
+  int32_t base = top & ~7;
+  uint8_t shift = top - base;
+  int32_t r0 = shift + glyph->top;
+  int32_t r1 = r0 + glyph->height;
+  if (r0 < (int32_t)u8g2->user_y0 - base) r0 = u8g2->user_y0 - base;
+  if (r1 > (int32_t)u8g2->user_y1 - base) r1 = u8g2->user_y1 - base;
+  if (r0 >= r1) return;
+  uint32_t mask = ((1UL << (r1 - r0)) - 1) << r0;
+
+  uint8_t* rows[PAGE_FONT_MAX_PAGES + 1];
+  uint8_t count = (r1 + 7) / 8;
+  uint16_t stride = u8g2_GetBufferTileWidth(u8g2) * 8;
+  for (uint8_t k = 0; k < count; k++) {
+    uint8_t row = base / 8 + k - u8g2->tile_curr_row;
+    rows[k] = (uint8_t)(mask >> (8 * k)) != 0 ? u8g2_GetBufferPtr(u8g2) + (uint16_t)row * stride : NULL;
+  }
+
+  uint8_t is_solid = u8g2->font_decode.is_transparent == 0;
+  uint8_t color = u8g2->draw_color;
+  for (int32_t x = x0; x < x1; x++) {
+    uint32_t column = 0;
+    for (uint8_t p = 0; p < page_font->pages; p++) {
+      column |= (uint32_t)*src++ << (8 * p);
+    }
+    column = (column << shift) & mask;
+
+    // Pixels to set and to clear, the solid mode also draws the background of the box
+    uint32_t set = color ? column : (is_solid ? mask & ~column : 0);
+    uint32_t clear = is_solid ? mask : (color ? 0 : column);
+    for (uint8_t k = 0; k < count; k++) {
+      if (rows[k] == NULL) continue;
+      uint8_t* dst = rows[k] + x;
+      *dst = (*dst & ~(uint8_t)(clear >> (8 * k))) | (uint8_t)(set >> (8 * k));
+    }
+  }
+}
+
+u8g2_uint_t PageFont_DrawGlyph(const PageFont_t* page_font, u8g2_t* u8g2, u8g2_uint_t x, u8g2_uint_t y,
+                               uint16_t encoding) {
+  const PageGlyph_t* glyph = page_font_find(page_font, encoding);
+  int32_t x0 = glyph != NULL ? (int32_t)x + glyph->x : -1;
+  int32_t top = (int32_t)y - page_font->ascent;
+  // Cells that start left of or above the display are left to u8g2, it wraps around
+  if (glyph == NULL || !page_font_is_blittable(u8g2) || x0 < 0 || x0 >= 0x8000 || top < 0 || top >= 0x8000) {
+    return page_font_draw_with_u8g2(page_font, u8g2, x, y, encoding);
+  }
+  if (glyph->width > 0) page_font_blit(page_font, glyph, u8g2, x0, top);
+  return (u8g2_uint_t)glyph->advance;
+}
+
+u8g2_uint_t PageFont_DrawStr(const PageFont_t* page_font, u8g2_t* u8g2, u8g2_uint_t x, u8g2_uint_t y,
+                             const char* str) {
+  u8g2_uint_t sum = 0;
+  for (; *str != '\0' && *str != '\n'; str++) {
+    u8g2_uint_t advance = PageFont_DrawGlyph(page_font, u8g2, x, y, (uint8_t)*str);
+    x += advance;
+    sum += advance;
+  }
+  return sum;
+}
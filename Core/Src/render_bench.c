@@ -0,0 +1,213 @@
+#include "render_bench.h"
+
+#include <stdio.h>
+
+#include "cycle_counter.h"
+#include "display_list.h"
+#include "face_wrapper.h"
+#include "page_font.h"
+#include "text_overlay.h"
+
+typedef void (*bench_fn_t)(u8g2_t* u8g2, uint32_t i);
+
+typedef struct {
+  const char* name;
+  bench_fn_t fn;
+  uint32_t iterations;
+} bench_case_t;
+
+static FaceHandle bench_face;
+static uint32_t bench_time;  // animation clock of the face cases, in ms
+static DisplayCommand_t bench_commands[FACE_COMMANDS_MAX];
+static DisplayList_t bench_list;
+#ifndef RENDER_BENCH_NO_FONTS
+#define BENCH_PAGE_FONT_CHARSET "0123456789CHT% "
+static TextOverlay_t bench_overlay;
+static uint8_t bench_overlay_bitmap[2 * 72];
+static uint16_t bench_glyph_index[256];  // u8g2_font_6x10_tf has the encodings 32..255
+static PageFont_t bench_page_font;
+static PageGlyph_t bench_page_glyphs[sizeof(BENCH_PAGE_FONT_CHARSET) - 1];
+static uint8_t bench_page_bitmap[(sizeof(BENCH_PAGE_FONT_CHARSET) - 1) * 6 * 2];  // 6x10, two pages
+#endif
+
+static void emit_result(void (*emit)(const char* line), const char* name, uint32_t iterations, uint32_t min,
+                        uint32_t avg) {
+  char line[128];
+  snprintf(line, sizeof(line), "{\"bench\":\"%s\",\"unit\":\"%s\",\"iterations\":%lu,\"min\":%lu,\"avg\":%lu}", name,
+           CYCLE_COUNTER_UNIT, (unsigned long)iterations, (unsigned long)min, (unsigned long)avg);
+  emit(line);
+}
+
+static void run_case(u8g2_t* u8g2, const bench_case_t* bc, void (*emit)(const char* line)) {
+  uint32_t min = UINT32_MAX;
+  uint32_t sum = 0;
+
+  for (uint32_t run = 0; run < RENDER_BENCH_RUNS; run++) {
+    uint32_t start = CycleCounter_Read();
+    for (uint32_t i = 0; i < bc->iterations; i++) {
+      bc->fn(u8g2, i);
+    }
+    uint32_t elapsed = CycleCounter_Read() - start;
+    if (elapsed < min) min = elapsed;
+    sum += elapsed;
+  }
+  emit_result(emit, bc->name, bc->iterations, min / bc->iterations, sum / (RENDER_BENCH_RUNS * bc->iterations));
+}
+
+// --- Cases, i is the iteration number to vary the input a little ---
+static void bench_clear_buffer(u8g2_t* u8g2, uint32_t i) {
+  (void)i;
+  u8g2_ClearBuffer(u8g2);
+}
+
+static void bench_draw_hline(u8g2_t* u8g2, uint32_t i) { u8g2_DrawHLine(u8g2, 10, i & 63, 100); }
+
+static void bench_draw_box(u8g2_t* u8g2, uint32_t i) { u8g2_DrawBox(u8g2, 20 + (i & 15), 17, 14, 30); }
+
+static void bench_draw_rbox(u8g2_t* u8g2, uint32_t i) { u8g2_DrawRBox(u8g2, 20 + (i & 15), 17, 14, 30, 4); }
+
+static void bench_draw_disc(u8g2_t* u8g2, uint32_t i) { u8g2_DrawDisc(u8g2, 64 + (i & 15), 32, 15, U8G2_DRAW_ALL); }
+
+#ifndef RENDER_BENCH_NO_FONTS
+static void bench_draw_str(u8g2_t* u8g2, uint32_t i) { u8g2_DrawStr(u8g2, i & 15, 20, "T 23C H 45%"); }
+
+// Same text through the overlay, rasterized on every call and cached
+static void bench_overlay_set_text(u8g2_t* u8g2, uint32_t i) {
+  TextOverlay_SetText(&bench_overlay, u8g2, (i & 1) ? "T 23C H 45%" : "T 24C H 45%");
+}
+
+static void bench_overlay_draw(u8g2_t* u8g2, uint32_t i) {
+  (void)i;
+  TextOverlay_Draw(&bench_overlay, u8g2);
+}
+
+// Same text blitted from the glyphs of u8g2_font_6x10_tf pre-decoded into a page font
+static void bench_page_font_draw_str(u8g2_t* u8g2, uint32_t i) {
+  PageFont_DrawStr(&bench_page_font, u8g2, i & 15, 20, "T 23C H 45%");
+}
+
+// Run with the glyph index of u8g2_font_6x10_tf assigned
+static const bench_case_t bench_glyph_index_case = {"u8g2_DrawStr_GlyphIndex", bench_draw_str, 64};
+
+static const bench_case_t bench_page_font_case = {"PageFont_DrawStr", bench_page_font_draw_str, 64};
+#endif
+
+// Moves the face one 10 ms frame on, the clock keeps running across runs and
+// cases. Each run of 256 frames (2.56 s) starts with an expression, so every
+// run draws eyes of changing height and offset. Blinks and looks come on their
+// own timers, every 4 to 8 s and 6 to 15 s.
+static void bench_face_step(uint32_t i) {
+  if (i % 256 == 0) {
+    Face_PlayExpression(bench_face, (FaceExpression)(bench_time / 2560 % (FACE_EXPRESSION_NOD + 1)));
+  }
+  bench_time += 10;
+  Face_Update(bench_face, bench_time);
+}
+
+static void bench_face_draw(u8g2_t* u8g2, uint32_t i) {
+  bench_face_step(i);
+  Face_Draw(bench_face, u8g2, bench_time);
+}
+
+static void bench_face_frame(u8g2_t* u8g2, uint32_t i) {
+  bench_face_step(i);
+  u8g2_ClearBuffer(u8g2);
+  Face_Draw(bench_face, u8g2, bench_time);
+}
+
+// Page buffer mode, emulated with a window of one page moved over the full buffer.
+// A u8g2_FirstPage/NextPage loop runs the whole frame code for every page.
+static void bench_face_pages(u8g2_t* u8g2, uint32_t i) {
+  bench_face_step(i);
+  uint8_t height = u8g2->tile_buf_height;
+  u8g2->tile_buf_height = 1;
+  for (uint8_t page = 0; page < height; page++) {
+    u8g2_SetBufferCurrTileRow(u8g2, page);
+    u8g2_ClearBuffer(u8g2);
+    DisplayList_Clear(&bench_list);
+    Face_Record(bench_face, &bench_list, bench_time);
+    for (uint8_t c = 0; c < bench_list.count; c++) {
+      bench_list.commands[c].draw(u8g2, &bench_list.commands[c]);
+    }
+  }
+  u8g2->tile_buf_height = height;
+  u8g2_SetBufferCurrTileRow(u8g2, 0);
+}
+
+// Same frame recorded once, every page replays only the commands that touch it
+static void bench_display_list_pages(u8g2_t* u8g2, uint32_t i) {
+  bench_face_step(i);
+  uint8_t height = u8g2->tile_buf_height;
+  DisplayList_Clear(&bench_list);
+  Face_Record(bench_face, &bench_list, bench_time);
+  u8g2->tile_buf_height = 1;
+  for (uint8_t page = 0; page < height; page++) {
+    u8g2_SetBufferCurrTileRow(u8g2, page);
+    u8g2_ClearBuffer(u8g2);
+    DisplayList_Replay(&bench_list, u8g2);
+  }
+  u8g2->tile_buf_height = height;
+  u8g2_SetBufferCurrTileRow(u8g2, 0);
+}
+
+static const bench_case_t bench_cases[] = {
+    {"u8g2_ClearBuffer", bench_clear_buffer, 64},
+    {"u8g2_DrawHLine", bench_draw_hline, 64},
+    {"u8g2_DrawBox", bench_draw_box, 64},
+    {"u8g2_DrawRBox", bench_draw_rbox, 64},
+    {"u8g2_DrawDisc", bench_draw_disc, 64},
+#ifndef RENDER_BENCH_NO_FONTS
+    {"u8g2_DrawStr", bench_draw_str, 64},
+    {"TextOverlay_SetText", bench_overlay_set_text, 64},
+    {"TextOverlay_Draw", bench_overlay_draw, 64},
+#endif
+    {"Face_Draw", bench_face_draw, 256},
+    {"Face_ClearAndDraw", bench_face_frame, 256},
+    {"Face_PageLoop", bench_face_pages, 256},
+    {"DisplayList_Pages", bench_display_list_pages, 256},
+};
+
+void RenderBench_Run(u8g2_t* u8g2, void (*emit)(const char* line)) {
+  CycleCounter_Init();
+
+#ifndef RENDER_BENCH_NO_FONTS
+  u8g2_SetFont(u8g2, u8g2_font_6x10_tf);
+  TextOverlay_Init(&bench_overlay, bench_overlay_bitmap, 8, 2, 72, 2, u8g2_font_6x10_tf);
+#endif
+  bench_face = Face_Create();
+  Face_Init(bench_face);
+  DisplayList_Init(&bench_list, bench_commands, FACE_COMMANDS_MAX);
+
+  for (uint32_t c = 0; c < sizeof(bench_cases) / sizeof(bench_cases[0]); c++) {
+    run_case(u8g2, &bench_cases[c], emit);
+  }
+
+#ifndef RENDER_BENCH_NO_FONTS
+  u8g2_SetGlyphIndexBuffer(u8g2, bench_glyph_index, sizeof(bench_glyph_index) / sizeof(bench_glyph_index[0]));
+  run_case(u8g2, &bench_glyph_index_case, emit);
+  u8g2_SetGlyphIndexBuffer(u8g2, NULL, 0);
+
+  if (PageFont_Init(&bench_page_font, u8g2, u8g2_font_6x10_tf, BENCH_PAGE_FONT_CHARSET, bench_page_glyphs,
+                    bench_page_bitmap, sizeof(bench_page_bitmap)) > 0) {
+    run_case(u8g2, &bench_page_font_case, emit);
+  } else {
+    emit("{\"bench\":\"PageFont_DrawStr\",\"skipped\":\"glyphs do not fit\"}");
+  }
+#else
+  emit("{\"bench\":\"u8g2_DrawStr\",\"skipped\":\"no fonts\"}");
+  emit("{\"bench\":\"TextOverlay_SetText\",\"skipped\":\"no fonts\"}");
+  emit("{\"bench\":\"TextOverlay_Draw\",\"skipped\":\"no fonts\"}");
+  emit("{\"bench\":\"u8g2_DrawStr_GlyphIndex\",\"skipped\":\"no fonts\"}");
+  emit("{\"bench\":\"PageFont_DrawStr\",\"skipped\":\"no fonts\"}");
+#endif
+
+  // Eye drawing paths for all eye heights, see benchmarkEyeDrawing
+  {
+    uint32_t rbox, sprite;
+    Face_BenchmarkEyes(u8g2, &rbox, &sprite);
+    emit_result(emit, "eyes_rbox_all_heights", 1, rbox, rbox);
+    emit_result(emit, "eyes_sprite_all_heights", 1, sprite, sprite);
+  }
+
+  u8g2_ClearBuffer(u8g2);
+}
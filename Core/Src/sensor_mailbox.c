@@ -0,0 +1,32 @@
+#include "sensor_mailbox.h"
+
+uint8_t SensorMailbox_Publish(SensorMailbox_t* mailbox, const SensorReading_t* reading) {
+  // Single writer, the fields may be read without the seqlock here
+  uint8_t changed = mailbox->version == 0 || reading->temperature != mailbox->reading.temperature ||
+                    reading->humidity != mailbox->reading.humidity;
+
+  uint32_t seq = atomic_load_explicit(&mailbox->seq, memory_order_relaxed);
+  atomic_store_explicit(&mailbox->seq, seq + 1, memory_order_relaxed);
+  atomic_thread_fence(memory_order_release);  // odd before the data
+
+  mailbox->reading = *reading;
+  if (changed) mailbox->version++;
+
+  atomic_store_explicit(&mailbox->seq, seq + 2, memory_order_release);  // data before even
+  return changed;
+}
+
+uint8_t SensorMailbox_Read(SensorMailbox_t* mailbox, SensorReading_t* reading, uint32_t* version) {
+  uint32_t seq;
+  uint32_t copied;
+  do {
+    seq = atomic_load_explicit(&mailbox->seq, memory_order_acquire);
+    *reading = mailbox->reading;
+    copied = mailbox->version;
+    atomic_thread_fence(memory_order_acquire);  // data before the second counter read
+  } while ((seq & 1U) || seq != atomic_load_explicit(&mailbox->seq, memory_order_relaxed));
+
+  if (copied == *version) return 0;
+  *version = copied;
+  return 1;
+}
@@ -0,0 +1,118 @@
+#include "text_overlay.h"
+
+#include <string.h>
+
+// Row of the area at page p in the buffer, NULL if the page is outside of the buffer window
+static uint8_t* text_overlay_row(const TextOverlay_t* overlay, u8g2_t* u8g2, uint8_t p) {
+  uint8_t row = overlay->page + p - u8g2->tile_curr_row;
+  if (row >= u8g2->tile_buf_height) return NULL;
+  uint16_t stride = u8g2_GetBufferTileWidth(u8g2) * 8;
+  return u8g2_GetBufferPtr(u8g2) + (uint16_t)row * stride + overlay->x;
+}
+
+// Draw the text into the bitmap pages first to first + count - 1, all in the buffer window
+static void text_overlay_rasterize(TextOverlay_t* overlay, u8g2_t* u8g2, uint8_t first, uint8_t count) {
+  // Keep what the buffer has in the area, draw the text on a clear area
+  for (uint8_t p = first; p < first + count; p++) {
+    uint8_t* row = text_overlay_row(overlay, u8g2, p);
+    memcpy(overlay->bitmap + p * overlay->width, row, overlay->width);
+    memset(row, 0, overlay->width);
+  }
+
+  u8g2_SetClipWindow(u8g2, overlay->x, (overlay->page + first) * 8, overlay->x + overlay->width,
+                     (overlay->page + first + count) * 8);
+  if (overlay->page_font != NULL) {
+    // The page font takes the baseline, u8g2 is set to the top of the font
+    PageFont_DrawStr(overlay->page_font, u8g2, overlay->x, overlay->page * 8 + u8g2->font_calc_vref(u8g2),
+                     overlay->text);
+  } else {
+    u8g2_DrawStr(u8g2, overlay->x, overlay->page * 8, overlay->text);
+  }
+  u8g2_SetMaxClipWindow(u8g2);
+
+  // The text goes to the bitmap, the buffer gets its content back
+  for (uint8_t p = first; p < first + count; p++) {
+    uint8_t* row = text_overlay_row(overlay, u8g2, p);
+    uint8_t* cached = overlay->bitmap + p * overlay->width;
+    for (uint8_t i = 0; i < overlay->width; i++) {
+      uint8_t glyphs = row[i];
+      row[i] = cached[i];
+      cached[i] = glyphs;
+    }
+  }
+}
+
+// Display list command recorded by TextOverlay_Record()
+static void text_overlay_replay(u8g2_t* u8g2, const DisplayCommand_t* command) {
+  TextOverlay_Draw((const TextOverlay_t*)command->data, u8g2);
+}
+
+void TextOverlay_Init(TextOverlay_t* overlay, uint8_t* bitmap, uint8_t x, uint8_t page, uint8_t width, uint8_t pages,
+                      const uint8_t* font) {
+  overlay->bitmap = bitmap;
+  overlay->font = font;
+  overlay->page_font = NULL;
+  overlay->x = x;
+  overlay->page = page;
+  overlay->width = width;
+  overlay->pages = pages;
+  overlay->revision = 0;
+  overlay->text[0] = '\0';
+  memset(bitmap, 0, (uint16_t)width * pages);
+}
+
+void TextOverlay_SetPageFont(TextOverlay_t* overlay, const PageFont_t* page_font) {
+  overlay->page_font = page_font;
+}
+
+uint8_t TextOverlay_SetText(TextOverlay_t* overlay, u8g2_t* u8g2, const char* text) {
+  if (strncmp(overlay->text, text, TEXT_OVERLAY_TEXT_MAX - 1) == 0) return 0;
+  strncpy(overlay->text, text, TEXT_OVERLAY_TEXT_MAX - 1);
+  overlay->text[TEXT_OVERLAY_TEXT_MAX - 1] = '\0';
+
+  overlay->revision++;
+
+  const uint8_t* font = u8g2->font;
+  u8g2_font_calc_vref_fnptr vref = u8g2->font_calc_vref;
+  uint8_t color = u8g2->draw_color;
+  uint8_t curr_row = u8g2->tile_curr_row;
+
+  u8g2_SetFont(u8g2, overlay->font);
+  u8g2_SetFontPosTop(u8g2);
+  u8g2_SetDrawColor(u8g2, 1);
+  // A page buffer is moved over the area, window by window
+  for (uint8_t p = 0; p < overlay->pages;) {
+    if (text_overlay_row(overlay, u8g2, p) == NULL) {
+      u8g2_SetBufferCurrTileRow(u8g2, overlay->page + p);
+    }
+    uint8_t count = u8g2->tile_curr_row + u8g2->tile_buf_height - (overlay->page + p);
+    if (count > overlay->pages - p) count = overlay->pages - p;
+    text_overlay_rasterize(overlay, u8g2, p, count);
+    p += count;
+  }
+  if (u8g2->tile_curr_row != curr_row) {
+    u8g2_SetBufferCurrTileRow(u8g2, curr_row);
+  }
+
+  // u8g2_SetFont() also reloads the font info
+  if (font != NULL) u8g2_SetFont(u8g2, font);
+  u8g2->font_calc_vref = vref;
+  u8g2->draw_color = color;
+  return 1;
+}
+
+void TextOverlay_Draw(const TextOverlay_t* overlay, u8g2_t* u8g2) {
+  for (uint8_t p = 0; p < overlay->pages; p++) {
+    uint8_t* row = text_overlay_row(overlay, u8g2, p);
+    if (row == NULL) continue;
+    const uint8_t* cached = overlay->bitmap + p * overlay->width;
+    for (uint8_t i = 0; i < overlay->width; i++) {
+      row[i] |= cached[i];
+    }
+  }
+}
+
+uint8_t TextOverlay_Record(const TextOverlay_t* overlay, DisplayList_t* list) {
+  return DisplayList_Add(list, text_overlay_replay, overlay, overlay->x, overlay->page * 8, overlay->width,
+                         overlay->pages * 8, overlay->revision);
+}
@@ -0,0 +1,20 @@
+#include "trace.h"
+
+#if TRACE_BINARY
+
+#include <string.h>
+
+#include "log.h"
+#include "timestamp.h"
+
+void Trace_Write(uint16_t id, const uint32_t* args, uint32_t count) {
+  uint32_t record[TRACE_HEADER_SIZE / 4 + TRACE_MAX_ARGS];
+
+  record[0] = TRACE_RECORD_MARK | (count << 8) | ((uint32_t)id << 16);
+  record[1] = Timestamp_Micros();
+  memcpy(&record[TRACE_HEADER_SIZE / 4], args, count * 4);
+
+  Log_Write(record, TRACE_HEADER_SIZE + count * 4);
+}
+
+#endif
@@ -0,0 +1,11 @@
+#ifndef HOST_CMSIS_OS_H
+#define HOST_CMSIS_OS_H
+
+/*
+ * Host stand-in for the CMSIS-RTOS v2 header. The face engine only needs the
+ * kernel tick, which is served by the simulated clock in host_clock.c.
+ */
+
+#include "host_clock.h"
+
+#endif  // HOST_CMSIS_OS_H
@@ -0,0 +1,31 @@
+#ifndef HOST_CYCLE_COUNTER_H
+#define HOST_CYCLE_COUNTER_H
+
+/*
+ * Host stand-in for the DWT cycle counter: a monotonic clock in nanoseconds,
+ * truncated to 32 bits like CYCCNT, so differences of reads work the same way
+ * (wraps after ~4.3 s).
+ */
+
+#include <stdint.h>
+#include <time.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CYCLE_COUNTER_UNIT "ns"
+
+static inline void CycleCounter_Init(void) {}
+
+static inline uint32_t CycleCounter_Read(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint32_t)((uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // HOST_CYCLE_COUNTER_H
@@ -0,0 +1,25 @@
+#ifndef HOST_CLOCK_H
+#define HOST_CLOCK_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Simulated kernel tick for host builds, 1 tick = 1 ms like on the target.
+ * Time only moves when the program advances it, so a run is reproducible
+ * and can render far faster than real time.
+ */
+void HostClock_Set(uint32_t tick);
+void HostClock_Advance(uint32_t ticks);
+
+// Same signature as the CMSIS-RTOS v2 call used by the face engine
+uint32_t osKernelGetTickCount(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // HOST_CLOCK_H
@@ -0,0 +1,28 @@
+#ifndef HOST_TIMESTAMP_H
+#define HOST_TIMESTAMP_H
+
+/*
+ * Host stand-in for the TIM3 timestamp service: a monotonic clock in
+ * microseconds, truncated to 32 bits like on the target.
+ */
+
+#include <stdint.h>
+#include <time.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static inline void Timestamp_Init(void) {}
+
+static inline uint32_t Timestamp_Micros(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint32_t)((uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // HOST_TIMESTAMP_H
@@ -0,0 +1,52 @@
+#ifndef U8G2_HOST_H
+#define U8G2_HOST_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "u8g2.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Exported constants --------------------------------------------------------*/
+#define U8G2_HOST_WIDTH 128
+#define U8G2_HOST_HEIGHT 64
+
+/* Exported functions prototypes ---------------------------------------------*/
+
+/**
+ * @brief  Set up u8g2 for the firmware's SH1106 128x64 I2C display, but with
+ *         the bytes going to an emulated controller in memory instead of the
+ *         bus. The whole u8g2 / u8x8 flush path runs as on the target.
+ * @param  u8g2: u8g2 instance
+ * @retval None
+ */
+void u8g2_Setup_sh1106_host(u8g2_t* u8g2);
+
+/**
+ * @brief  Display RAM of the emulated controller, in u8g2 tile layout
+ *         (8 pages of 128 bytes, bit 0 is the top row of a page).
+ * @retval Pointer to U8G2_HOST_WIDTH * U8G2_HOST_HEIGHT / 8 bytes
+ */
+const uint8_t* u8g2_host_GetDisplayRam(void);
+
+/**
+ * @brief  Number of data bytes the controller received since the last call.
+ * @retval Data bytes written to the display RAM
+ */
+uint32_t u8g2_host_TakeDataBytes(void);
+
+/**
+ * @brief  Write the display RAM as a PBM image.
+ * @param  file: open output file
+ * @retval None
+ */
+void u8g2_host_WritePbm(FILE* file);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // U8G2_HOST_H
@@ -0,0 +1,110 @@
+/*
+ * Headless face renderer: runs the face engine against the emulated display
+ * with a simulated clock, as fast as the host allows.
+ *
+ *   face_render [-n frames] [-p period_ms] [-o dir]
+ *
+ * -n  number of frame slots to simulate (default 3000, one minute at 50 FPS)
+ * -p  frame period in ms (default 20)
+ * -o  write every frame that changed the display as dir/frame_NNNNNN.pbm
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "display_list.h"
+#include "face_wrapper.h"
+#include "host_clock.h"
+#include "u8g2.h"
+#include "u8g2_host.h"
+
+#define START_TICK 1000
+
+static double now_seconds(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static int write_frame(const char* dir, uint32_t index) {
+  char path[512];
+  snprintf(path, sizeof(path), "%s/frame_%06u.pbm", dir, index);
+  FILE* file = fopen(path, "w");
+  if (file == NULL) {
+    perror(path);
+    return -1;
+  }
+  u8g2_host_WritePbm(file);
+  fclose(file);
+  return 0;
+}
+
+int main(int argc, char** argv) {
+  uint32_t frames = 3000;
+  uint32_t period = 20;
+  const char* out_dir = NULL;
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+      frames = (uint32_t)strtoul(argv[++i], NULL, 0);
+    } else if (strcmp(argv[i], "-p") == 0 && i + 1 < argc) {
+      period = (uint32_t)strtoul(argv[++i], NULL, 0);
+    } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+      out_dir = argv[++i];
+    } else {
+      fprintf(stderr, "usage: %s [-n frames] [-p period_ms] [-o dir]\n", argv[0]);
+      return 2;
+    }
+  }
+  if (period == 0) period = 1;
+
+  static u8g2_t u8g2;
+  static DisplayCommand_t commands[FACE_COMMANDS_MAX];
+  static DisplayList_t list;
+
+  HostClock_Set(START_TICK);
+  u8g2_Setup_sh1106_host(&u8g2);
+  u8g2_InitDisplay(&u8g2);
+  u8g2_SetPowerSave(&u8g2, 0);
+  u8g2_host_TakeDataBytes();
+  DisplayList_Init(&list, commands, FACE_COMMANDS_MAX);
+
+  FaceHandle face = Face_Create();
+  Face_Init(face);
+
+  uint32_t rendered = 0;
+  uint32_t written = 0;
+  uint64_t bytes_sent = 0;
+  double start = now_seconds();
+
+  // Same steps as StartDisplayTask, minus the scheduler sleeping between changes
+  for (uint32_t frame = 0; frame < frames; frame++) {
+    uint32_t current_time = osKernelGetTickCount();
+
+    Face_Update(face, current_time);
+    if (Face_IsDirty(face, current_time)) {
+      DisplayList_Clear(&list);
+      Face_Record(face, &list, current_time);
+      DisplayList_Render(&list, &u8g2);
+      rendered++;
+
+      uint32_t sent = u8g2_host_TakeDataBytes();
+      bytes_sent += sent;
+      if (out_dir != NULL && sent > 0) {
+        if (write_frame(out_dir, frame) != 0) return 1;
+        written++;
+      }
+    }
+    HostClock_Advance(period);
+  }
+
+  double elapsed = now_seconds() - start;
+  printf("simulated %u frames (%.1f s), rendered %u, sent %llu bytes\n", frames, frames * period / 1000.0, rendered,
+         (unsigned long long)bytes_sent);
+  printf("host time %.3f s, %.0f frames/s\n", elapsed, elapsed > 0 ? frames / elapsed : 0.0);
+  if (out_dir != NULL) {
+    printf("wrote %u frames to %s\n", written, out_dir);
+  }
+  return 0;
+}
@@ -0,0 +1,342 @@
+/*
+ * u8g2 glyph lookup with and without the glyph index, one JSON line per case.
+ *
+ *   font_bench > fonts.jsonl
+ *
+ * The host build has no u8g2 fonts, so a test font in the u8g2 font format is
+ * built at startup: glyphs 32..126 and 160..255 with random pixels, and three
+ * unicode ranges behind a lookup table. Every encoding from 0 to 0xffff is
+ * looked up with and without the index, both must give the same glyph data.
+ * Then lookups and u8g2_DrawStr() are timed both ways.
+ *
+ * The digits and units of the test font are then pre-decoded into a page font.
+ * Random strings, also with characters it does not have, are drawn with
+ * PageFont_DrawStr() and u8g2_DrawStr() at random positions (also across the
+ * display edges and page boundaries), clip windows, draw colors 0/1, font
+ * modes and page buffer windows over a random background, both buffers must
+ * be equal. Then the cost per glyph is timed both ways.
+ *
+ * Exits with 1 if any lookup or buffer differs.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cycle_counter.h"
+#include "page_font.h"
+#include "u8g2.h"
+#include "u8g2_host.h"
+
+#define BENCH_RUNS 8
+#define BENCH_ITERATIONS 256
+
+// Bit widths of the test font
+#define BITS_0 4
+#define BITS_1 3
+#define BITS_W 4
+#define BITS_H 4
+#define BITS_X 2
+#define BITS_Y 3
+#define BITS_DX 4
+#define GLYPH_MAX_W 6
+#define GLYPH_MAX_H 8
+#define GLYPH_DESCENT 2
+#define UNICODE_BLOCK 16  // glyphs per entry of the unicode lookup table
+#define BUF_SIZE (U8G2_HOST_WIDTH * U8G2_HOST_HEIGHT / 8)
+#define PAGE_FONT_CHARSET "0123456789.-C% "
+#define PAGE_FONT_TEXT "23.4C 45%"
+
+// Internal to u8g2_font.c
+#define U8G2_FONT_DATA_STRUCT_SIZE 23
+const uint8_t* u8g2_font_get_glyph_data(u8g2_t* u8g2, uint16_t encoding);
+
+static uint8_t test_font[32768];
+static uint16_t glyph_index_buf[1024];
+static PageGlyph_t page_glyphs[sizeof(PAGE_FONT_CHARSET) - 1];
+static uint8_t page_bitmap[sizeof(PAGE_FONT_CHARSET) * GLYPH_MAX_W * 2];
+static uint8_t ref_buf[BUF_SIZE];
+
+typedef struct {
+  uint8_t* p;
+  uint8_t bit;
+} bit_writer_t;
+
+// LSB first, as read by u8g2_font_decode_get_unsigned_bits()
+static void put_bits(bit_writer_t* w, uint32_t value, uint8_t cnt) {
+  for (uint8_t i = 0; i < cnt; i++) {
+    if (w->bit == 0) *w->p = 0;
+    if ((value >> i) & 1) *w->p |= 1 << w->bit;
+    if (++w->bit == 8) {
+      w->bit = 0;
+      w->p++;
+    }
+  }
+}
+
+static void put_signed_bits(bit_writer_t* w, int value, uint8_t cnt) { put_bits(w, value + (1 << (cnt - 1)), cnt); }
+
+// One glyph with random pixels, returns the end of its data
+static uint8_t* put_glyph(uint8_t* p, uint16_t encoding) {
+  uint8_t* start = p;
+  int w = 0, h = 0, y = 0;
+  if (encoding != ' ') {
+    w = 3 + rand() % (GLYPH_MAX_W - 2);
+    h = 5 + rand() % (GLYPH_MAX_H - 4);
+    y = -(rand() % (GLYPH_DESCENT + 1));
+  }
+
+  if (encoding > 255) *p++ = encoding >> 8;
+  *p++ = encoding & 0xff;
+  uint8_t* size = p++;
+
+  bit_writer_t bits = {p, 0};
+  put_bits(&bits, w, BITS_W);
+  put_bits(&bits, h, BITS_H);
+  put_signed_bits(&bits, 0, BITS_X);
+  put_signed_bits(&bits, y, BITS_Y);
+  put_signed_bits(&bits, w + 1, BITS_DX);
+
+  // Runs of background and foreground pixels, row by row
+  uint8_t pixels[GLYPH_MAX_W * GLYPH_MAX_H];
+  for (int i = 0; i < w * h; i++) pixels[i] = (rand() % 5) < 2;
+  for (int i = 0; i < w * h;) {
+    int zeros = 0, ones = 0;
+    while (i < w * h && !pixels[i] && zeros < (1 << BITS_0) - 1) zeros++, i++;
+    while (i < w * h && pixels[i] && ones < (1 << BITS_1) - 1) ones++, i++;
+    put_bits(&bits, zeros, BITS_0);
+    put_bits(&bits, ones, BITS_1);
+    put_bits(&bits, 0, 1);  // no repetition of the pair
+  }
+
+  p = bits.p + (bits.bit != 0);
+  *size = p - start;
+  return p;
+}
+
+static void put_word(uint8_t* p, uint16_t value) {
+  p[0] = value >> 8;
+  p[1] = value & 0xff;
+}
+
+static void build_test_font(void) {
+  static const uint16_t unicode_ranges[][2] = {{0x100, 0x17f}, {0x391, 0x3c9}, {0x2190, 0x21ff}};
+  uint8_t* data = test_font + U8G2_FONT_DATA_STRUCT_SIZE;
+  uint8_t* p = data;
+  uint8_t glyph_cnt = 0;
+
+  for (uint16_t e = 32; e <= 255; e++) {
+    if (e > 126 && e < 160) continue;
+    if (e == 'A') put_word(test_font + 17, p - data);
+    if (e == 'a') put_word(test_font + 19, p - data);
+    p = put_glyph(p, e);
+    glyph_cnt++;
+  }
+  *p++ = 0;  // a glyph size of 0 ends the glyphs up to 255
+  *p++ = 0;
+
+  // Lookup table, each entry holds the distance to the first glyph of its
+  // block and the last encoding of the block, the last one 0xffff
+  put_word(test_font + 21, p - data);
+  uint16_t block_cnt = 0;
+  for (unsigned r = 0; r < sizeof(unicode_ranges) / sizeof(unicode_ranges[0]); r++) {
+    uint16_t n = unicode_ranges[r][1] - unicode_ranges[r][0] + 1;
+    block_cnt += (n + UNICODE_BLOCK - 1) / UNICODE_BLOCK;
+  }
+  uint8_t* table = p;
+  uint8_t* entry = table;
+  uint8_t* block_start = table;
+  p += 4 * block_cnt;
+  for (unsigned r = 0; r < sizeof(unicode_ranges) / sizeof(unicode_ranges[0]); r++) {
+    for (uint16_t e = unicode_ranges[r][0]; e <= unicode_ranges[r][1]; e++) {
+      if ((e - unicode_ranges[r][0]) % UNICODE_BLOCK == 0) {
+        put_word(entry, p - block_start);
+        block_start = p;
+        entry += 4;
+      }
+      p = put_glyph(p, e);
+      put_word(entry - 2, e);
+    }
+  }
+  put_word(entry - 2, 0xffff);
+  *p++ = 0;  // encoding 0 ends the unicode glyphs
+  *p++ = 0;
+
+  uint8_t* h = test_font;
+  h[0] = glyph_cnt;
+  h[1] = 0;  // bbx mode
+  h[2] = BITS_0;
+  h[3] = BITS_1;
+  h[4] = BITS_W;
+  h[5] = BITS_H;
+  h[6] = BITS_X;
+  h[7] = BITS_Y;
+  h[8] = BITS_DX;
+  h[9] = GLYPH_MAX_W;
+  h[10] = GLYPH_MAX_H + GLYPH_DESCENT;
+  h[11] = 0;
+  h[12] = (uint8_t)-GLYPH_DESCENT;
+  h[13] = GLYPH_MAX_H;
+  h[14] = (uint8_t)-GLYPH_DESCENT;
+  h[15] = GLYPH_MAX_H;
+  h[16] = (uint8_t)-GLYPH_DESCENT;
+}
+
+static uint32_t time_lookups(u8g2_t* u8g2, const uint16_t* encodings, int cnt) {
+  uint32_t min = UINT32_MAX;
+  volatile uintptr_t sink = 0;
+  for (int run = 0; run < BENCH_RUNS; run++) {
+    uint32_t start = CycleCounter_Read();
+    for (int i = 0; i < BENCH_ITERATIONS; i++) {
+      for (int c = 0; c < cnt; c++) sink += (uintptr_t)u8g2_font_get_glyph_data(u8g2, encodings[c]);
+    }
+    uint32_t elapsed = CycleCounter_Read() - start;
+    if (elapsed < min) min = elapsed;
+  }
+  return min / (BENCH_ITERATIONS * cnt);
+}
+
+static uint32_t time_draw_str(u8g2_t* u8g2, const char* str) {
+  uint32_t min = UINT32_MAX;
+  for (int run = 0; run < BENCH_RUNS; run++) {
+    uint32_t start = CycleCounter_Read();
+    for (int i = 0; i < BENCH_ITERATIONS; i++) u8g2_DrawStr(u8g2, 4, 40, str);
+    uint32_t elapsed = CycleCounter_Read() - start;
+    if (elapsed < min) min = elapsed;
+  }
+  return min / BENCH_ITERATIONS;
+}
+
+// Draws a random string both ways, returns 1 if the buffers are equal
+static int compare_page_font(u8g2_t* u8g2, const PageFont_t* page_font, int report) {
+  static const char chars[] = PAGE_FONT_CHARSET "AT~";
+  char str[8];
+  int len = rand() % (sizeof(str) - 1);
+  for (int i = 0; i < len; i++) str[i] = chars[rand() % (sizeof(chars) - 1)];
+  str[len] = '\0';
+  int x = rand() % 160 - 16, y = rand() % 96 - 16;
+
+  // Page buffer emulated with a window of one page, as in render_bench
+  uint8_t height = u8g2->tile_buf_height;
+  if (rand() & 1) {
+    u8g2->tile_buf_height = 1;
+    u8g2_SetBufferCurrTileRow(u8g2, rand() % height);
+  }
+  if (rand() & 1) {
+    int cx0 = rand() % U8G2_HOST_WIDTH, cy0 = rand() % U8G2_HOST_HEIGHT;
+    u8g2_SetClipWindow(u8g2, cx0, cy0, cx0 + 1 + rand() % U8G2_HOST_WIDTH, cy0 + 1 + rand() % U8G2_HOST_HEIGHT);
+  } else {
+    u8g2_SetMaxClipWindow(u8g2);
+  }
+  u8g2_SetDrawColor(u8g2, rand() & 1);
+  u8g2_SetFontMode(u8g2, rand() & 1);
+
+  uint8_t* buf = u8g2_GetBufferPtr(u8g2);
+  for (int i = 0; i < BUF_SIZE; i++) buf[i] = rand();
+  uint8_t background[BUF_SIZE];
+  memcpy(background, buf, BUF_SIZE);
+  u8g2_uint_t ref_width = u8g2_DrawStr(u8g2, x, y, str);
+  memcpy(ref_buf, buf, BUF_SIZE);
+  memcpy(buf, background, BUF_SIZE);
+  u8g2_uint_t width = PageFont_DrawStr(page_font, u8g2, x, y, str);
+  int is_equal = width == ref_width && memcmp(buf, ref_buf, BUF_SIZE) == 0;
+  if (!is_equal && report) {
+    fprintf(stderr, "PageFont_DrawStr(%d, %d, \"%s\") differs, window %u/%u, color %u, font mode %u\n", x, y, str,
+            u8g2->tile_curr_row, u8g2->tile_buf_height, u8g2->draw_color, u8g2->font_decode.is_transparent);
+  }
+
+  u8g2->tile_buf_height = height;
+  u8g2_SetBufferCurrTileRow(u8g2, 0);
+  return is_equal;
+}
+
+static uint32_t time_page_font(u8g2_t* u8g2, const PageFont_t* page_font, const char* str) {
+  uint32_t min = UINT32_MAX;
+  for (int run = 0; run < BENCH_RUNS; run++) {
+    uint32_t start = CycleCounter_Read();
+    for (int i = 0; i < BENCH_ITERATIONS; i++) PageFont_DrawStr(page_font, u8g2, 4, 40, str);
+    uint32_t elapsed = CycleCounter_Read() - start;
+    if (elapsed < min) min = elapsed;
+  }
+  return min / BENCH_ITERATIONS;
+}
+
+int main(void) {
+  static const uint16_t ascii[] = {'2', '3', '.', '4', 'C', ' ', '4', '5', '%', 'T', 'z', '~'};
+  static const uint16_t latin1[] = {0xa0, 0xb0, 0xc4, 0xd6, 0xdf, 0xe4, 0xf6, 0xfc};
+  static const uint16_t unicode[] = {0x101, 0x17e, 0x391, 0x3a3, 0x3c9, 0x2190, 0x21d2, 0x21ff};
+  static const struct {
+    const char* name;
+    const uint16_t* encodings;
+    int cnt;
+  } cases[] = {
+      {"glyph_lookup_ascii", ascii, sizeof(ascii) / sizeof(ascii[0])},
+      {"glyph_lookup_latin1", latin1, sizeof(latin1) / sizeof(latin1[0])},
+      {"glyph_lookup_unicode", unicode, sizeof(unicode) / sizeof(unicode[0])},
+  };
+  u8g2_t u8g2;
+  int mismatches = 0;
+
+  srand(1);
+  build_test_font();
+  u8g2_Setup_sh1106_host(&u8g2);
+  u8g2_SetFont(&u8g2, test_font);
+
+  uint16_t words = u8g2_BuildGlyphIndex(&u8g2.glyph_index, test_font, NULL, 0);
+  if (words == 0 || words > sizeof(glyph_index_buf) / sizeof(glyph_index_buf[0])) {
+    fprintf(stderr, "test font can not be indexed (%u words)\n", words);
+    return 1;
+  }
+
+  // Every encoding, linear search against the index
+  for (uint32_t e = 0; e <= 0xffff; e++) {
+    u8g2_SetGlyphIndexBuffer(&u8g2, NULL, 0);
+    const uint8_t* linear = u8g2_font_get_glyph_data(&u8g2, e);
+    u8g2_SetGlyphIndexBuffer(&u8g2, glyph_index_buf, words);
+    const uint8_t* indexed = u8g2_font_get_glyph_data(&u8g2, e);
+    if (linear != indexed && mismatches++ == 0) {
+      fprintf(stderr, "encoding 0x%04x: glyph at %ld, index gives %ld\n", (unsigned)e,
+              linear ? (long)(linear - test_font) : -1L, indexed ? (long)(indexed - test_font) : -1L);
+    }
+  }
+
+  for (unsigned c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+    u8g2_SetGlyphIndexBuffer(&u8g2, NULL, 0);
+    uint32_t linear = time_lookups(&u8g2, cases[c].encodings, cases[c].cnt);
+    u8g2_SetGlyphIndexBuffer(&u8g2, glyph_index_buf, words);
+    uint32_t indexed = time_lookups(&u8g2, cases[c].encodings, cases[c].cnt);
+    printf("{\"bench\":\"%s\",\"unit\":\"%s\",\"linear\":%lu,\"index\":%lu}\n", cases[c].name, CYCLE_COUNTER_UNIT,
+           (unsigned long)linear, (unsigned long)indexed);
+  }
+
+  u8g2_SetGlyphIndexBuffer(&u8g2, NULL, 0);
+  uint32_t linear = time_draw_str(&u8g2, "23.4C 45%");
+  u8g2_SetGlyphIndexBuffer(&u8g2, glyph_index_buf, words);
+  uint32_t indexed = time_draw_str(&u8g2, "23.4C 45%");
+  printf("{\"bench\":\"u8g2_DrawStr\",\"unit\":\"%s\",\"linear\":%lu,\"index\":%lu,\"index_words\":%u,"
+         "\"checked\":65536,\"mismatches\":%d}\n",
+         CYCLE_COUNTER_UNIT, (unsigned long)linear, (unsigned long)indexed, words, mismatches);
+
+  PageFont_t page_font;
+  uint16_t bitmap_bytes =
+      PageFont_Init(&page_font, &u8g2, test_font, PAGE_FONT_CHARSET, page_glyphs, page_bitmap, sizeof(page_bitmap));
+  if (bitmap_bytes == 0) {
+    fprintf(stderr, "test font can not be pre-decoded\n");
+    return 1;
+  }
+  int page_font_mismatches = 0;
+  for (int i = 0; i < 20000; i++) {
+    if (!compare_page_font(&u8g2, &page_font, page_font_mismatches == 0)) page_font_mismatches++;
+  }
+
+  // Cost per glyph, u8g2 with the glyph index against the page font
+  u8g2_SetMaxClipWindow(&u8g2);
+  u8g2_SetDrawColor(&u8g2, 1);
+  u8g2_SetFontMode(&u8g2, 0);
+  uint32_t glyphs = strlen(PAGE_FONT_TEXT);
+  uint32_t decoded = time_draw_str(&u8g2, PAGE_FONT_TEXT) / glyphs;
+  uint32_t blitted = time_page_font(&u8g2, &page_font, PAGE_FONT_TEXT) / glyphs;
+  printf("{\"bench\":\"glyph_page_font\",\"unit\":\"%s\",\"u8g2\":%lu,\"page_font\":%lu,\"bitmap_bytes\":%u,"
+         "\"checked\":20000,\"mismatches\":%d}\n",
+         CYCLE_COUNTER_UNIT, (unsigned long)decoded, (unsigned long)blitted, bitmap_bytes, page_font_mismatches);
+  return mismatches != 0 || page_font_mismatches != 0;
+}
@@ -0,0 +1,9 @@
+#include "host_clock.h"
+
+static uint32_t host_tick = 0;
+
+void HostClock_Set(uint32_t tick) { host_tick = tick; }
+
+void HostClock_Advance(uint32_t ticks) { host_tick += ticks; }
+
+uint32_t osKernelGetTickCount(void) { return host_tick; }
@@ -0,0 +1,28 @@
+/*
+ * Render benchmark suite on the host, one JSON line per case on stdout.
+ *
+ *   render_bench > bench.jsonl
+ *
+ * Times are in ns of the host CPU, useful to compare changes to the drawing
+ * code against each other, not against the target.
+ */
+#include <stdio.h>
+
+#include "host_clock.h"
+#include "render_bench.h"
+#include "u8g2.h"
+#include "u8g2_host.h"
+
+static void emit_line(const char* line) { puts(line); }
+
+int main(void) {
+  static u8g2_t u8g2;
+
+  HostClock_Set(0);
+  u8g2_Setup_sh1106_host(&u8g2);
+  u8g2_InitDisplay(&u8g2);
+  u8g2_SetPowerSave(&u8g2, 0);
+
+  RenderBench_Run(&u8g2, emit_line);
+  return 0;
+}
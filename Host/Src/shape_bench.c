@@ -0,0 +1,154 @@
+/*
+ * Span rasterizer against the hvline paths of u8g2, one JSON line per case.
+ *
+ *   shape_bench > shapes.jsonl
+ *
+ * u8g2_DrawRBox, u8g2_DrawDisc and u8g2_DrawFilledEllipse are drawn twice:
+ * with U8G2_R0, which takes the span rasterizer of u8g2_span.c, and with a
+ * copy of the U8G2_R0 callbacks, which u8g2 does not recognize and draws
+ * through the original hvline code. Every case first sweeps sizes, positions
+ * (also across the display edges), clip windows and draw colors 0/1 over a
+ * random background and compares both buffers, then times both paths.
+ *
+ * Exits with 1 if any buffer differs.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cycle_counter.h"
+#include "u8g2.h"
+#include "u8g2_host.h"
+
+#define BUF_SIZE (U8G2_HOST_WIDTH * U8G2_HOST_HEIGHT / 8)
+#define BENCH_RUNS 8
+#define BENCH_ITERATIONS 256
+
+typedef enum { SHAPE_RBOX, SHAPE_DISC, SHAPE_ELLIPSE } shape_t;
+
+typedef struct {
+  shape_t shape;
+  int x, y;
+  int a, b, c;  // w, h, r / rad, -, option / rx, ry, option
+} shape_args_t;
+
+static u8g2_t span_u8g2;
+static u8g2_t ref_u8g2;
+static u8g2_cb_t ref_cb;
+static uint8_t ref_buf[BUF_SIZE];
+
+static void draw(u8g2_t* u8g2, const shape_args_t* s) {
+  switch (s->shape) {
+    case SHAPE_RBOX:
+      u8g2_DrawRBox(u8g2, s->x, s->y, s->a, s->b, s->c);
+      break;
+    case SHAPE_DISC:
+      u8g2_DrawDisc(u8g2, s->x, s->y, s->a, s->c);
+      break;
+    case SHAPE_ELLIPSE:
+      u8g2_DrawFilledEllipse(u8g2, s->x, s->y, s->a, s->b, s->c);
+      break;
+  }
+}
+
+static void random_args(shape_t shape, shape_args_t* s) {
+  s->shape = shape;
+  s->x = rand() % 160 - 16;
+  s->y = rand() % 96 - 16;
+  switch (shape) {
+    case SHAPE_RBOX:
+      s->c = rand() % 12;
+      s->a = 2 * s->c + 1 + rand() % 64;
+      s->b = 2 * s->c + rand() % 48;
+      if (s->b == 0) s->b = 1;
+      break;
+    case SHAPE_DISC:
+      s->a = rand() % (U8G2_SPAN_MAX_RADIUS + 1);
+      s->c = 1 + rand() % U8G2_DRAW_ALL;
+      break;
+    case SHAPE_ELLIPSE:
+      // rx = ry = 0 never leaves the first loop of u8g2_draw_filled_ellipse()
+      s->a = rand() % 80;
+      s->b = rand() % (U8G2_SPAN_MAX_RADIUS + 1);
+      if (s->a == 0 && s->b == 0) s->a = 1;
+      s->c = 1 + rand() % U8G2_DRAW_ALL;
+      break;
+  }
+}
+
+// Draws the shape both ways, returns 1 if the buffers are equal
+static int compare(const shape_args_t* s) {
+  uint8_t color = rand() & 1;
+  if (rand() & 1) {
+    int cx0 = rand() % U8G2_HOST_WIDTH, cy0 = rand() % U8G2_HOST_HEIGHT;
+    int cx1 = cx0 + 1 + rand() % U8G2_HOST_WIDTH, cy1 = cy0 + 1 + rand() % U8G2_HOST_HEIGHT;
+    u8g2_SetClipWindow(&span_u8g2, cx0, cy0, cx1, cy1);
+    u8g2_SetClipWindow(&ref_u8g2, cx0, cy0, cx1, cy1);
+  } else {
+    u8g2_SetMaxClipWindow(&span_u8g2);
+    u8g2_SetMaxClipWindow(&ref_u8g2);
+  }
+  u8g2_SetDrawColor(&span_u8g2, color);
+  u8g2_SetDrawColor(&ref_u8g2, color);
+
+  uint8_t* buf = u8g2_GetBufferPtr(&span_u8g2);
+  for (int i = 0; i < BUF_SIZE; i++) buf[i] = rand();
+  memcpy(ref_buf, buf, BUF_SIZE);
+
+  draw(&span_u8g2, s);
+  draw(&ref_u8g2, s);
+  return memcmp(buf, ref_buf, BUF_SIZE) == 0;
+}
+
+static uint32_t time_draw(u8g2_t* u8g2, const shape_args_t* s) {
+  uint32_t min = UINT32_MAX;
+  u8g2_SetMaxClipWindow(u8g2);
+  u8g2_SetDrawColor(u8g2, 1);
+  for (int run = 0; run < BENCH_RUNS; run++) {
+    uint32_t start = CycleCounter_Read();
+    for (int i = 0; i < BENCH_ITERATIONS; i++) draw(u8g2, s);
+    uint32_t elapsed = CycleCounter_Read() - start;
+    if (elapsed < min) min = elapsed;
+  }
+  return min / BENCH_ITERATIONS;
+}
+
+int main(void) {
+  static const struct {
+    const char* name;
+    shape_args_t timed;
+  } cases[] = {
+      {"u8g2_DrawRBox", {SHAPE_RBOX, 20, 17, 14, 30, 4}},
+      {"u8g2_DrawDisc", {SHAPE_DISC, 64, 32, 15, 0, U8G2_DRAW_ALL}},
+      {"u8g2_DrawFilledEllipse", {SHAPE_ELLIPSE, 64, 32, 30, 12, U8G2_DRAW_ALL}},
+  };
+  int failed = 0;
+
+  u8g2_Setup_sh1106_host(&span_u8g2);
+  u8g2_Setup_sh1106_host(&ref_u8g2);
+  ref_cb = *U8G2_R0;
+  u8g2_SetDisplayRotation(&ref_u8g2, &ref_cb);
+  ref_u8g2.tile_buf_ptr = ref_buf;
+  srand(1);
+
+  for (unsigned c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+    int checked = 0, mismatches = 0;
+    for (int i = 0; i < 20000; i++) {
+      shape_args_t s;
+      random_args(cases[c].timed.shape, &s);
+      checked++;
+      if (!compare(&s)) {
+        if (mismatches++ == 0) {
+          fprintf(stderr, "%s(%d, %d, %d, %d, %d) differs\n", cases[c].name, s.x, s.y, s.a, s.b, s.c);
+        }
+      }
+    }
+    if (mismatches) failed = 1;
+
+    uint32_t hvline = time_draw(&ref_u8g2, &cases[c].timed);
+    uint32_t span = time_draw(&span_u8g2, &cases[c].timed);
+    printf("{\"bench\":\"%s\",\"unit\":\"%s\",\"hvline\":%lu,\"span\":%lu,\"checked\":%d,\"mismatches\":%d}\n",
+           cases[c].name, CYCLE_COUNTER_UNIT, (unsigned long)hvline, (unsigned long)span, checked, mismatches);
+  }
+  return failed;
+}
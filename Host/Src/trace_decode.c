@@ -0,0 +1,142 @@
+/*
+ * Decoder for the binary trace stream of the firmware (see Core/Inc/trace.h).
+ *
+ *   trace_decode stm32-dev.trace_fmt [capture]
+ *
+ * Reads the captured UART output from the file or stdin, text passes through
+ * unchanged, trace records are formatted with the string table the build
+ * dumps from the .trace_fmt section and printed as one line each:
+ *
+ *   [  12.034518] [USER] [WARN] Missed 1 frame deadline(s), total 3
+ *
+ * Decoding a live port: stty -F /dev/ttyUSB0 115200 raw && trace_decode stm32-dev.trace_fmt /dev/ttyUSB0
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "trace_format.h"
+
+static char* table;
+static size_t table_size;
+
+static int load_table(const char* path) {
+  FILE* file = fopen(path, "rb");
+  if (file == NULL) {
+    perror(path);
+    return -1;
+  }
+  fseek(file, 0, SEEK_END);
+  long size = ftell(file);
+  fseek(file, 0, SEEK_SET);
+
+  table = malloc(size + 1);
+  table_size = fread(table, 1, size, file);
+  table[table_size] = '\0';  // a truncated last string still ends
+  fclose(file);
+  return 0;
+}
+
+static uint32_t read_le32(const uint8_t* p) { return p[0] | p[1] << 8 | p[2] << 16 | (uint32_t)p[3] << 24; }
+
+// printf with argument words: length modifiers are dropped, every conversion takes one word
+static void print_formatted(const char* fmt, const uint32_t* args, uint32_t count) {
+  uint32_t next = 0;
+
+  while (*fmt) {
+    if (*fmt != '%') {
+      putchar(*fmt++);
+      continue;
+    }
+    if (fmt[1] == '%') {
+      putchar('%');
+      fmt += 2;
+      continue;
+    }
+
+    char spec[32];
+    size_t n = 0;
+    spec[n++] = *fmt++;
+    while (*fmt && strchr("-+ #0123456789.", *fmt) && n < sizeof(spec) - 3) spec[n++] = *fmt++;
+    while (*fmt && strchr("hlLqjzt", *fmt)) fmt++;
+    char conv = *fmt ? *fmt++ : '\0';
+
+    uint32_t word = next < count ? args[next] : 0;
+    next++;
+    switch (conv) {
+      case 'd':
+      case 'i':
+        spec[n++] = 'd';
+        spec[n] = '\0';
+        printf(spec, (int32_t)word);
+        break;
+      case 'u':
+      case 'o':
+      case 'x':
+      case 'X':
+      case 'c':
+        spec[n++] = conv;
+        spec[n] = '\0';
+        printf(spec, word);
+        break;
+      case 'p':
+        printf("0x%08x", word);
+        break;
+      default:
+        printf("<%%%c?>", conv);
+        break;
+    }
+  }
+  if (next != count) printf(" <%u args for %u conversions>", count, next);
+}
+
+int main(int argc, char** argv) {
+  if (argc < 2 || argc > 3) {
+    fprintf(stderr, "usage: %s table.trace_fmt [capture]\n", argv[0]);
+    return 2;
+  }
+  if (load_table(argv[1]) != 0) return 1;
+
+  FILE* in = stdin;
+  if (argc == 3) {
+    in = fopen(argv[2], "rb");
+    if (in == NULL) {
+      perror(argv[2]);
+      return 1;
+    }
+  }
+  setvbuf(stdout, NULL, _IOLBF, 0);
+
+  int c;
+  while ((c = getc(in)) != EOF) {
+    if (c != TRACE_RECORD_MARK) {
+      if (c != '\r') putchar(c);
+      continue;
+    }
+
+    uint8_t header[TRACE_HEADER_SIZE];
+    header[0] = c;
+    if (fread(header + 1, 1, TRACE_HEADER_SIZE - 1, in) != TRACE_HEADER_SIZE - 1) break;
+
+    uint32_t count = header[1];
+    uint32_t id = header[2] | header[3] << 8;
+    uint32_t micros = read_le32(header + 4);
+    if (count > TRACE_MAX_ARGS || id >= table_size) {
+      printf("<bad trace record, id %u, %u args>\n", id, count);
+      continue;
+    }
+
+    uint8_t payload[TRACE_MAX_ARGS * 4];
+    uint32_t args[TRACE_MAX_ARGS];
+    if (fread(payload, 4, count, in) != count) break;
+    for (uint32_t i = 0; i < count; i++) args[i] = read_le32(payload + 4 * i);
+
+    printf("[%4u.%06u] ", micros / 1000000, micros % 1000000);
+    print_formatted(table + id, args, count);
+    putchar('\n');
+  }
+
+  if (in != stdin) fclose(in);
+  return 0;
+}
@@ -0,0 +1,146 @@
+#include "u8g2_host.h"
+
+#include <string.h>
+
+/*
+ * SH1106 emulation. Every I2C transfer starts with a control byte: with Co set
+ * one byte follows and then another control byte, with Co clear the rest of
+ * the transfer is a stream. D/C selects display data or commands. Only the
+ * addressing commands change the emulated state, commands with arguments are
+ * skipped together with their arguments.
+ */
+#define SH1106_X_OFFSET 2
+#define SH1106_CTRL_CO 0x80
+#define SH1106_CTRL_DC 0x40
+
+static uint8_t display_ram[U8G2_HOST_HEIGHT / 8][U8G2_HOST_WIDTH];
+static uint8_t ram_page = 0;
+static uint8_t ram_column = 0;  // controller column, display column + SH1106_X_OFFSET
+static uint32_t data_bytes = 0;
+
+static uint8_t expect_control = 1;
+static uint8_t is_single = 0;
+static uint8_t is_data = 0;
+static uint8_t cmd_args_left = 0;
+
+static uint8_t sh1106_cmd_arg_count(uint8_t cmd) {
+  switch (cmd) {
+    case 0x81:  // contrast
+    case 0x8D:  // charge pump (SSD1306)
+    case 0x20:  // memory addressing mode (SSD1306)
+    case 0xA8:  // multiplex ratio
+    case 0xAD:  // DC-DC control
+    case 0xD3:  // display offset
+    case 0xD5:  // clock divide
+    case 0xD9:  // pre-charge period
+    case 0xDA:  // COM pins
+    case 0xDB:  // VCOM deselect level
+      return 1;
+    case 0x21:  // column range (SSD1306)
+    case 0x22:  // page range (SSD1306)
+      return 2;
+    default:
+      return 0;
+  }
+}
+
+static void sh1106_command(uint8_t cmd) {
+  if (cmd_args_left > 0) {
+    cmd_args_left--;
+  } else if (cmd <= 0x0F) {
+    ram_column = (ram_column & 0xF0) | cmd;
+  } else if (cmd <= 0x1F) {
+    ram_column = (uint8_t)((ram_column & 0x0F) | ((cmd & 0x0F) << 4));
+  } else if ((cmd & 0xF8) == 0xB0) {
+    ram_page = cmd & 0x07;
+  } else {
+    cmd_args_left = sh1106_cmd_arg_count(cmd);
+  }
+}
+
+static void sh1106_data(uint8_t data) {
+  int x = (int)ram_column - SH1106_X_OFFSET;
+  if (x >= 0 && x < U8G2_HOST_WIDTH) {
+    display_ram[ram_page][x] = data;
+  }
+  ram_column++;  // the column address wraps in the controller, bytes past the RAM are dropped
+  data_bytes++;
+}
+
+static void sh1106_receive(uint8_t byte) {
+  if (expect_control) {
+    is_single = (byte & SH1106_CTRL_CO) != 0;
+    is_data = (byte & SH1106_CTRL_DC) != 0;
+    expect_control = 0;
+    return;
+  }
+  if (is_data) {
+    sh1106_data(byte);
+  } else {
+    sh1106_command(byte);
+  }
+  if (is_single) {
+    expect_control = 1;
+  }
+}
+
+static uint8_t u8x8_byte_host_i2c(u8x8_t* u8x8, uint8_t msg, uint8_t arg_int, void* arg_ptr) {
+  const uint8_t* data;
+
+  switch (msg) {
+    case U8X8_MSG_BYTE_INIT:
+    case U8X8_MSG_BYTE_SET_DC:
+    case U8X8_MSG_BYTE_END_TRANSFER:
+      break;
+
+    case U8X8_MSG_BYTE_START_TRANSFER:
+      expect_control = 1;
+      break;
+
+    case U8X8_MSG_BYTE_SEND:
+      data = (const uint8_t*)arg_ptr;
+      while (arg_int > 0) {
+        sh1106_receive(*data++);
+        arg_int--;
+      }
+      break;
+
+    default:
+      return 0;
+  }
+  return 1;
+}
+
+static uint8_t u8x8_gpio_and_delay_host(u8x8_t* u8x8, uint8_t msg, uint8_t arg_int, void* arg_ptr) {
+  return 1;  // no pins and no delays on the host
+}
+
+void u8g2_Setup_sh1106_host(u8g2_t* u8g2) {
+  memset(display_ram, 0, sizeof(display_ram));
+  ram_page = 0;
+  ram_column = 0;
+  data_bytes = 0;
+  cmd_args_left = 0;
+  expect_control = 1;
+
+  u8g2_Setup_sh1106_i2c_128x64_noname_f(u8g2, U8G2_R0, u8x8_byte_host_i2c, u8x8_gpio_and_delay_host);
+}
+
+const uint8_t* u8g2_host_GetDisplayRam(void) { return &display_ram[0][0]; }
+
+uint32_t u8g2_host_TakeDataBytes(void) {
+  uint32_t n = data_bytes;
+  data_bytes = 0;
+  return n;
+}
+
+static FILE* pbm_file;
+
+static void pbm_out(const char* s) { fputs(s, pbm_file); }
+
+void u8g2_host_WritePbm(FILE* file) {
+  pbm_file = file;
+  u8x8_capture_write_pbm_pre(U8G2_HOST_WIDTH / 8, U8G2_HOST_HEIGHT / 8, pbm_out);
+  u8x8_capture_write_pbm_buffer(&display_ram[0][0], U8G2_HOST_WIDTH / 8, U8G2_HOST_HEIGHT / 8,
+                                u8x8_capture_get_pixel_1, pbm_out);
+}
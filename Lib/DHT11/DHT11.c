@@ -11,6 +11,13 @@
 #define DHT11_MAX_DATA_BITS 40
 #define DHT11_MAX_BYTE_PACKETS 5
 #define DHT11_MAX_TIMEOUT 100
+#define DHT11_START_PULSE_MS 20
+
+// Input capture mode, a full frame takes about 5ms
+#define DHT11_CAPTURE_TIMEOUT_MS 10
+#define DHT11_RESPONSE_MIN_US 120 // 80us LOW + 80us HIGH
+#define DHT11_RESPONSE_MAX_US 200
+#define DHT11_BIT_THRESHOLD_US 100 // 50us LOW + 28us HIGH for 0, 50us LOW + 70us HIGH for 1
 
 #define TEMP_C_TO_F(x) (((x) * 1.8f) + (32))
 
@@ -21,6 +28,9 @@ const char* const ErrorMsg[__DHT11_STATUS_TYPEDEF_COUNT__] = {
 		"CHECKSUM MISMATCH"
 };
 
+// Instance waiting for its capture DMA, completed from HAL_TIM_IC_CaptureCallback
+static DHT11_InitTypeDef *volatile DHT11_Capturing = NULL;
+
 static void HAL_DelayUs(TIM_HandleTypeDef *tim, uint16_t us) {
 	__HAL_TIM_SET_COUNTER(tim, 0);
 	while(__HAL_TIM_GET_COUNTER(tim) < us);
@@ -46,6 +56,34 @@ static void DHT11_SetPinMode(DHT11_InitTypeDef *DHT11, uint8_t MODE) {
 	HAL_GPIO_Init(DHT11->_GPIOx, &GPIO_CFG);
 }
 
+static void DHT11_DelayMs(uint32_t ms) {
+	// Let the other tasks run during the start pulse
+	if(osKernelGetState() == osKernelRunning) {
+		osDelay(ms);
+	} else {
+		HAL_Delay(ms);
+	}
+}
+
+// PULLING the Line to LOW for the start pulse, the caller releases it
+static void DHT11_StartPulse(DHT11_InitTypeDef *DHT11) {
+	HAL_GPIO_WritePin(DHT11->_GPIOx, DHT11->_Pin, GPIO_PIN_RESET);
+	DHT11_SetPinMode(DHT11, DHT11_PIN_OUTPUT);
+	DHT11_DelayMs(DHT11_START_PULSE_MS);
+}
+
+static DHT11_StatusTypeDef DHT11_StorePackets(DHT11_InitTypeDef *DHT11, const uint8_t *Packets) {
+	// Last 8 bits are Checksum, which is the sum of all the previously transmitted 4 bytes
+	if(Packets[4] != (uint8_t)(Packets[0] + Packets[1] + Packets[2] + Packets[3])) {
+		return DHT11_CHECKSUM_MISMATCH;
+	}
+
+	DHT11->Humidity = Packets[0] + (Packets[1] * 0.1f);
+	DHT11->Temperature = Packets[2] + (Packets[3] * 0.1f);
+
+	return DHT11_OK;
+}
+
 void HAL_DHT11_Init(
 		DHT11_InitTypeDef *DHT11,
 		GPIO_TypeDef *GPIOx,
@@ -58,9 +96,30 @@ void HAL_DHT11_Init(
 	DHT11->Temperature = 0.0f;
 	DHT11->Humidity = 0.0f;
 
+	DHT11->_UseCapture = 0;
+
 	HAL_TIM_Base_Start(DHT11->_Tim);
 }
 
+void HAL_DHT11_InitCapture(
+		DHT11_InitTypeDef *DHT11,
+		GPIO_TypeDef *GPIOx,
+		uint16_t GPIO_Pin,
+		TIM_HandleTypeDef *TIM,
+		uint32_t Channel
+) {
+	DHT11->_GPIOx = GPIOx;
+	DHT11->_Pin = GPIO_Pin;
+	DHT11->_Tim = TIM;
+	DHT11->_Channel = Channel;
+	DHT11->_UseCapture = 1;
+	DHT11->Temperature = 0.0f;
+	DHT11->Humidity = 0.0f;
+
+	// The line idles HIGH through the pull-up, the pin stays an input between reads
+	DHT11_SetPinMode(DHT11, DHT11_PIN_INPUT);
+}
+
 void HAL_DHT11_DeInit(DHT11_InitTypeDef *DHT11) {
 	HAL_GPIO_DeInit(DHT11->_GPIOx, DHT11->_Pin);
 	HAL_TIM_Base_Stop(DHT11->_Tim);
@@ -75,10 +134,7 @@ static DHT11_StatusTypeDef DHT11_ReadData(DHT11_InitTypeDef *DHT11) {
 	uint8_t Packets[DHT11_MAX_BYTE_PACKETS] = {0};
 	uint8_t PacketIndex = 0;
 
-	DHT11_SetPinMode(DHT11, DHT11_PIN_OUTPUT);
-	// PULLING the Line to Low and waits for 20ms
-	HAL_GPIO_WritePin(DHT11->_GPIOx, DHT11->_Pin, GPIO_PIN_RESET);
-	HAL_Delay(20);
+	DHT11_StartPulse(DHT11);
 	// PULLING the Line to HIGH and waits for 40us
 	HAL_GPIO_WritePin(DHT11->_GPIOx, DHT11->_Pin, GPIO_PIN_SET);
 	HAL_DelayUs(DHT11->_Tim, 40);
@@ -131,21 +187,83 @@ static DHT11_StatusTypeDef DHT11_ReadData(DHT11_InitTypeDef *DHT11) {
 
 	__enable_irq();
 
-	// Last 8 bits are Checksum, which is the sum of all the previously transmitted 4 bytes
-	if(Packets[4] != (Packets[0] + Packets[1] + Packets[2] + Packets[3])) {
-		return DHT11_CHECKSUM_MISMATCH;
+	return DHT11_StorePackets(DHT11, Packets);
+}
+
+static DHT11_StatusTypeDef DHT11_DecodeEdges(DHT11_InitTypeDef *DHT11) {
+	const uint16_t *Edges = DHT11->_Edges;
+	uint8_t Packets[DHT11_MAX_BYTE_PACKETS] = {0};
+
+	// Edges[0]: the DHT11 PULLS the Line to LOW to respond, then HIGH for the handshake
+	// Edges[1]: end of the handshake, the first bit starts
+	uint16_t Response = Edges[1] - Edges[0];
+	if(Response < DHT11_RESPONSE_MIN_US || Response > DHT11_RESPONSE_MAX_US) {
+		return DHT11_ERROR;
 	}
 
-	DHT11->Humidity = Packets[0] + (Packets[1] * 0.1f);
-	DHT11->Temperature = Packets[2] + (Packets[3] * 0.1f);
+	// Every bit ends with the falling edge that starts the next one, the
+	// distance between falling edges tells 0 from 1 (the counter wraps safely)
+	for(uint8_t Bits = 0; Bits < DHT11_MAX_DATA_BITS; Bits++) {
+		uint16_t Period = Edges[Bits + 2] - Edges[Bits + 1];
+		Packets[Bits / 8] = (Packets[Bits / 8] << 1) | (Period > DHT11_BIT_THRESHOLD_US);
+	}
 
-	return DHT11_OK;
+	return DHT11_StorePackets(DHT11, Packets);
+}
+
+static DHT11_StatusTypeDef DHT11_ReadDataCapture(DHT11_InitTypeDef *DHT11) {
+	TIM_HandleTypeDef *Tim = DHT11->_Tim;
+	DMA_HandleTypeDef *Dma = Tim->hdma[DHT11->_Channel == TIM_CHANNEL_1 ? TIM_DMA_ID_CC1 :
+	                                    DHT11->_Channel == TIM_CHANNEL_2 ? TIM_DMA_ID_CC2 :
+	                                    DHT11->_Channel == TIM_CHANNEL_3 ? TIM_DMA_ID_CC3 : TIM_DMA_ID_CC4];
+
+	DHT11_StartPulse(DHT11);
+
+	DHT11->_Thread = osThreadGetId();
+	osThreadFlagsClear(DHT11_CAPTURE_FLAG);
+	DHT11_Capturing = DHT11;
+
+	// Arm the capture while the line is still held LOW, the response can follow the release within 20us
+	__HAL_TIM_CLEAR_FLAG(Tim, (TIM_FLAG_CC1 | TIM_FLAG_CC1OF) << (DHT11->_Channel >> 2));
+	if(HAL_TIM_IC_Start_DMA(Tim, DHT11->_Channel, (uint32_t *)DHT11->_Edges, DHT11_CAPTURE_EDGES) != HAL_OK) {
+		DHT11_Capturing = NULL;
+		DHT11_SetPinMode(DHT11, DHT11_PIN_INPUT);
+		return DHT11_ERROR;
+	}
+
+	// Release the Line, the pull-up takes it HIGH and the DHT11 answers
+	DHT11_SetPinMode(DHT11, DHT11_PIN_INPUT);
+
+	uint32_t Flags = osThreadFlagsWait(DHT11_CAPTURE_FLAG, osFlagsWaitAny, DHT11_CAPTURE_TIMEOUT_MS);
+	uint16_t Captured = DHT11_CAPTURE_EDGES - __HAL_DMA_GET_COUNTER(Dma);
+
+	HAL_TIM_IC_Stop_DMA(Tim, DHT11->_Channel);
+	DHT11_Capturing = NULL;
+
+	if(Flags & osFlagsError) {
+		// No edge at all means the DHT11 is not responding
+		return Captured == 0 ? DHT11_ERROR : DHT11_TIMEOUT;
+	}
+
+	return DHT11_DecodeEdges(DHT11);
 }
 
 DHT11_StatusTypeDef HAL_DHT11_ReadData(DHT11_InitTypeDef *DHT11) {
+	if(DHT11->_UseCapture) {
+		return DHT11->Status = DHT11_ReadDataCapture(DHT11);
+	}
 	return DHT11->Status = DHT11_ReadData(DHT11);
 }
 
+void HAL_TIM_IC_CaptureCallback(TIM_HandleTypeDef *htim) {
+	DHT11_InitTypeDef *DHT11 = DHT11_Capturing;
+
+	// Called by the HAL when the capture DMA has stored all edges
+	if(DHT11 != NULL && htim == DHT11->_Tim) {
+		osThreadFlagsSet(DHT11->_Thread, DHT11_CAPTURE_FLAG);
+	}
+}
+
 float HAL_DHT11_ReadTemperatureC(DHT11_InitTypeDef *DHT11) {
 	HAL_DHT11_ReadData(DHT11);
 	return DHT11->Temperature;
@@ -4,10 +4,16 @@
 #include <stdint.h>
 #include "stm32f1xx_hal.h"
 #include "stm32f1xx_hal_tim.h"
+#include "cmsis_os.h"
 
 #define __DHT11_VER_MAJ__ 1
-#define __DHT11_VER_MIN__ 0
-#define __DHT11_VER_PATCH__ 1
+#define __DHT11_VER_MIN__ 1
+#define __DHT11_VER_PATCH__ 0
+
+/* Falling edges of a frame: response, start of the first bit, end of each of the 40 bits */
+#define DHT11_CAPTURE_EDGES 42
+/* Thread flag set for the reading task when the capture DMA completes */
+#define DHT11_CAPTURE_FLAG 0x0100U
 
 #ifdef __cplusplus
 extern "C" {
@@ -34,6 +40,10 @@ typedef struct {
 	uint16_t _Pin;
 	GPIO_TypeDef *_GPIOx;
 	TIM_HandleTypeDef *_Tim;
+	uint32_t _Channel;
+	uint8_t _UseCapture;
+	osThreadId_t _Thread;
+	uint16_t _Edges[DHT11_CAPTURE_EDGES];
 } DHT11_InitTypeDef;
 
 /**
@@ -46,8 +56,24 @@ typedef struct {
   */
 void HAL_DHT11_Init(DHT11_InitTypeDef *DHT11, GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, TIM_HandleTypeDef *TIM);
 
+/**
+  * @brief  Intitalizes the DHT11 Driver in input capture mode. The frame is
+  *         recorded as timestamps of the falling edges by the timer channel
+  *         and DMA, then decoded, the CPU and interrupts stay free during the read.
+  *         The timer channel must be configured for input capture on the falling
+  *         edge with a DMA channel linked, the pin is its input.
+  * @param	DHT11 instance of a DHT11 driver.
+  * @param  GPIOx where x can be (A..G) to select the GPIO peripheral for STM32xxxx family.
+  * @param  GPIO_Pin specifies the pin DHT11 is connected.
+  * @param 	TIM handler for timer with frequency to count 1us.
+  * @param 	Channel TIM_CHANNEL_x the pin is the input of.
+  * @retval None
+  */
+void HAL_DHT11_InitCapture(DHT11_InitTypeDef *DHT11, GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, TIM_HandleTypeDef *TIM, uint32_t Channel);
+
 /**
   * @brief  Reads data(Temperature, Humidity) from the DHT11 Driver.
+  *         In input capture mode the calling task blocks until the frame is received.
   * @param	DHT11 instance of a DHT11 driver.
   * @retval DHT11_StatusTypeDef
   */
@@ -175,6 +175,33 @@
 #define U8G2_BALANCED_STR_WIDTH_CALCULATION
 #endif
 
+/*
+  The following macro enables the area fill of u8g2_span.c for the vertical_top_lsb buffer.
+  u8g2_DrawBox() and u8g2_DrawSpans() write each page row of the buffer once with 
+  the combined mask of all rows within the page, using 32 bit stores, instead of 
+  one hvline per pixel row. u8g2_DrawRBox(), u8g2_DrawDisc() and u8g2_DrawFilledEllipse()
+  are converted to one span per row (same pixels as the hvline version) for draw 
+  colors 0 and 1. Other buffer types and rotations still use hvlines.
+  Costs 68 bytes in u8g2_t for the cached row extents.
+*/
+#ifndef U8G2_WITHOUT_SPAN_FILL
+#define U8G2_WITH_SPAN_FILL
+#endif
+
+/*
+  The following macro enables the glyph index. u8g2_font_get_glyph_data() walks 
+  through the glyph list of the font (or the unicode lookup table and the glyphs 
+  after it) for every character. If a buffer is assigned with 
+  u8g2_SetGlyphIndexBuffer(), u8g2_SetFont() stores the offset of every glyph in 
+  this buffer: encodings up to 255 are looked up directly, unicode glyphs with a 
+  binary search. Without a buffer, or if the index of a font does not fit, the 
+  glyphs are searched as before.
+  Costs 24 bytes in u8g2_t, the buffer is provided by the application.
+*/
+#ifndef U8G2_WITHOUT_GLYPH_INDEX
+#define U8G2_WITH_GLYPH_INDEX
+#endif
+
 
 /*==========================================*/
 
@@ -310,6 +337,40 @@ struct u8g2_cb_struct
 
 typedef u8g2_uint_t (*u8g2_font_calc_vref_fnptr)(u8g2_t *u8g2);
 
+#ifdef U8G2_WITH_SPAN_FILL
+/* one pixel row of a shape, x0 included, x1 excluded, x0 may be negative, empty if x0 == x1 */
+typedef struct
+{
+  u8g2_uint_t x0;
+  u8g2_uint_t x1;
+} u8g2_span_t;
+
+/* largest radius of the discs and largest vertical radius of the ellipses drawn with spans */
+#define U8G2_SPAN_MAX_RADIUS 31
+/* largest horizontal radius of the ellipses drawn with spans */
+#define U8G2_SPAN_MAX_RX 63
+
+/* row extents of a disc or ellipse, computed once per radius */
+typedef struct
+{
+  uint8_t rx;		/* 0xff: nothing computed yet */
+  uint8_t ry;
+  uint8_t hw[U8G2_SPAN_MAX_RADIUS+1];	/* half width of the row dy away from the center, hw[0] = 0xff: no spans */
+} u8g2_span_extent_t;
+#endif /* U8G2_WITH_SPAN_FILL */
+
+#ifdef U8G2_WITH_GLYPH_INDEX
+/* glyph offsets of a font, built by u8g2_BuildGlyphIndex() */
+typedef struct
+{
+  const uint8_t *font;		/* font of the index, NULL if there is no index */
+  const uint16_t *table;	/* cnt entries for encodings first.., then unicode_cnt pairs (encoding, offset) */
+  uint16_t first;		/* encoding of table[0] */
+  uint16_t cnt;			/* table[e-first]: glyph offset + 1 from the end of the font header, 0 if missing */
+  uint16_t unicode_cnt;		/* pairs of the glyphs above 255, sorted by encoding */
+} u8g2_glyph_index_t;
+#endif /* U8G2_WITH_GLYPH_INDEX */
+
 
 struct u8g2_struct
 {
@@ -383,6 +444,16 @@ struct u8g2_struct
 	// the following variable should be renamed to is_buffer_auto_clear
   uint8_t is_auto_page_clear; 		/* set to 0 to disable automatic clear of the buffer in firstPage() and nextPage() */
   
+#ifdef U8G2_WITH_SPAN_FILL
+  u8g2_span_extent_t disc_extent;		/* last disc radius, also used for the corners of u8g2_DrawRBox() */
+  u8g2_span_extent_t ellipse_extent;	/* last filled ellipse radii */
+#endif /* U8G2_WITH_SPAN_FILL */
+
+#ifdef U8G2_WITH_GLYPH_INDEX
+  u8g2_glyph_index_t glyph_index;	/* index of the current font, if it fits into the buffer */
+  uint16_t *glyph_index_buf;		/* NULL: no glyph index */
+  uint16_t glyph_index_buf_len;	/* in words */
+#endif /* U8G2_WITH_GLYPH_INDEX */
 };
 
 #define u8g2_GetU8x8(u8g2) ((u8x8_t *)(u8g2))
@@ -1869,6 +1940,16 @@ void u8g2_DrawFrame(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t y, u8g2_uint_t w, u
 void u8g2_DrawRBox(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t y, u8g2_uint_t w, u8g2_uint_t h, u8g2_uint_t r);
 void u8g2_DrawRFrame(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t y, u8g2_uint_t w, u8g2_uint_t h, u8g2_uint_t r);
 
+/*==========================================*/
+/* u8g2_span.c */
+#ifdef U8G2_WITH_SPAN_FILL
+uint8_t u8g2_span_fill_box(u8g2_t *u8g2, u8g2_uint_t x0, u8g2_uint_t y0, u8g2_uint_t x1, u8g2_uint_t y1);
+uint8_t u8g2_span_rbox(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t y, u8g2_uint_t w, u8g2_uint_t h, u8g2_uint_t r);
+uint8_t u8g2_span_disc(u8g2_t *u8g2, u8g2_uint_t x0, u8g2_uint_t y0, u8g2_uint_t rad, uint8_t option);
+uint8_t u8g2_span_filled_ellipse(u8g2_t *u8g2, u8g2_uint_t x0, u8g2_uint_t y0, u8g2_uint_t rx, u8g2_uint_t ry, uint8_t option);
+void u8g2_DrawSpans(u8g2_t *u8g2, u8g2_uint_t y, u8g2_uint_t h, const u8g2_span_t *spans);
+#endif /* U8G2_WITH_SPAN_FILL */
+
 /*==========================================*/
 /* u8g2_button.c */
 
@@ -1932,6 +2013,11 @@ size_t u8g2_GetFontSize(const uint8_t *font_arg);
 void u8g2_SetFont(u8g2_t *u8g2, const uint8_t  *font);
 void u8g2_SetFontMode(u8g2_t *u8g2, uint8_t is_transparent);
 
+#ifdef U8G2_WITH_GLYPH_INDEX
+uint16_t u8g2_BuildGlyphIndex(u8g2_glyph_index_t *index, const uint8_t *font, uint16_t *buf, uint16_t len);
+void u8g2_SetGlyphIndexBuffer(u8g2_t *u8g2, uint16_t *buf, uint16_t len);
+#endif /* U8G2_WITH_GLYPH_INDEX */
+
 uint8_t u8g2_IsGlyph(u8g2_t *u8g2, uint16_t requested_encoding);
 int8_t u8g2_GetGlyphWidth(u8g2_t *u8g2, uint16_t requested_encoding);
 
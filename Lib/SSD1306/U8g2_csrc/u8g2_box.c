@@ -45,6 +45,10 @@ void u8g2_DrawBox(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t y, u8g2_uint_t w, u8g
   if ( u8g2_IsIntersection(u8g2, x, y, x+w, y+h) == 0 ) 
     return;
 #endif /* U8G2_WITH_INTERSECTION */
+#ifdef U8G2_WITH_SPAN_FILL
+  if ( u8g2_span_fill_box(u8g2, x, y, x+w, y+h) != 0 )
+    return;
+#endif /* U8G2_WITH_SPAN_FILL */
   while( h != 0 )
   { 
     u8g2_DrawHVLine(u8g2, x, y, w, 0);
@@ -95,6 +99,11 @@ void u8g2_DrawRBox(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t y, u8g2_uint_t w, u8
     return;
 #endif /* U8G2_WITH_INTERSECTION */
 
+#ifdef U8G2_WITH_SPAN_FILL
+  if ( u8g2_span_rbox(u8g2, x, y, w, h, r) != 0 )
+    return;
+#endif /* U8G2_WITH_SPAN_FILL */
+
   xl = x;
   xl += r;
   yu = y;
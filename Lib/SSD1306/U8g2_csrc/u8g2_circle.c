@@ -202,6 +202,11 @@ void u8g2_DrawDisc(u8g2_t *u8g2, u8g2_uint_t x0, u8g2_uint_t y0, u8g2_uint_t rad
   }
 #endif /* U8G2_WITH_INTERSECTION */
   
+#ifdef U8G2_WITH_SPAN_FILL
+  if ( u8g2_span_disc(u8g2, x0, y0, rad, option) != 0 )
+    return;
+#endif /* U8G2_WITH_SPAN_FILL */
+
   /* draw disc */
   u8g2_draw_disc(u8g2, x0, y0, rad, option);
 }
@@ -473,6 +478,11 @@ void u8g2_DrawFilledEllipse(u8g2_t *u8g2, u8g2_uint_t x0, u8g2_uint_t y0, u8g2_u
   }
 #endif /* U8G2_WITH_INTERSECTION */
   
+#ifdef U8G2_WITH_SPAN_FILL
+  if ( u8g2_span_filled_ellipse(u8g2, x0, y0, rx, ry, option) != 0 )
+    return;
+#endif /* U8G2_WITH_SPAN_FILL */
+
   u8g2_draw_filled_ellipse(u8g2, x0, y0, rx, ry, option);
 }
 
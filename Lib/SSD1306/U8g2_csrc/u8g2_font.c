@@ -771,6 +771,136 @@ int8_t u8g2_font_2x_decode_glyph(u8g2_t *u8g2, const uint8_t *glyph_data)
   return d*2;
 }
 
+#ifdef U8G2_WITH_GLYPH_INDEX
+/*
+  Store the glyph offsets of the font in buf. Encodings up to 255 get one word 
+  each from the first to the last glyph, glyphs above 255 two words.
+  Returns the number of words required, 0 if the font can not be indexed
+  (glyphs not sorted or too far from the font start). index->font is set only 
+  if the index has been built, buf may be NULL to ask for the size.
+*/
+uint16_t u8g2_BuildGlyphIndex(u8g2_glyph_index_t *index, const uint8_t *font, uint16_t *buf, uint16_t len)
+{
+  const uint8_t *data = font + U8G2_FONT_DATA_STRUCT_SIZE;
+  const uint8_t *glyph;
+  uint16_t first = 0;
+  uint16_t cnt = 0;
+  uint16_t unicode_cnt = 0;
+  uint16_t e;
+  uint16_t i;
+  uint32_t size;
+  
+  index->font = NULL;
+  
+  /* encodings up to 255, ascending, a glyph size of 0 ends the list */
+  for( glyph = data; u8x8_pgm_read( glyph + 1 ) != 0; glyph += u8x8_pgm_read( glyph + 1 ) )
+  {
+    e = u8x8_pgm_read( glyph );
+    if ( cnt == 0 )
+      first = e;
+    else if ( e < first + cnt )
+      return 0;
+    cnt = e - first + 1;
+  }
+  
+#ifdef U8G2_WITH_UNICODE
+  /* the unicode glyphs follow the lookup table, its first entry is the size of the table */
+  glyph = data + u8g2_font_get_word(font, 21);
+  glyph += u8g2_font_get_word(glyph, 0);
+  for(;;)
+  {
+    e = u8g2_font_get_word(glyph, 0);
+    if ( e == 0 )
+      break;
+    unicode_cnt++;
+    glyph += u8x8_pgm_read( glyph + 2 );
+  }
+#endif
+  
+  size = cnt + 2UL*unicode_cnt;
+  if ( size > 0x0ffff || (uint32_t)(glyph - data) >= 0x0ffff )
+    return 0;
+  if ( buf == NULL || size > len )
+    return size;
+  
+  for( i = 0; i < cnt; i++ )
+    buf[i] = 0;
+  for( glyph = data; u8x8_pgm_read( glyph + 1 ) != 0; glyph += u8x8_pgm_read( glyph + 1 ) )
+    buf[u8x8_pgm_read( glyph ) - first] = (glyph - data) + 1;
+  
+#ifdef U8G2_WITH_UNICODE
+  glyph = data + u8g2_font_get_word(font, 21);
+  glyph += u8g2_font_get_word(glyph, 0);
+  for( i = cnt; i < size; i += 2 )
+  {
+    e = u8g2_font_get_word(glyph, 0);
+    /* the binary search needs ascending encodings */
+    if ( i > cnt && e <= buf[i-2] )
+      return 0;
+    buf[i] = e;
+    buf[i+1] = glyph - data;
+    glyph += u8x8_pgm_read( glyph + 2 );
+  }
+#endif
+  
+  index->font = font;
+  index->table = buf;
+  index->first = first;
+  index->cnt = cnt;
+  index->unicode_cnt = unicode_cnt;
+  return size;
+}
+
+/*
+  Assign a buffer for the glyph index, NULL removes the index. The index is built 
+  for the current font and again by every u8g2_SetFont() with another font.
+  The buffer must stay valid, see u8g2_BuildGlyphIndex() for the size.
+*/
+void u8g2_SetGlyphIndexBuffer(u8g2_t *u8g2, uint16_t *buf, uint16_t len)
+{
+  u8g2->glyph_index_buf = buf;
+  u8g2->glyph_index_buf_len = len;
+  u8g2->glyph_index.font = NULL;
+  if ( buf != NULL && u8g2->font != NULL )
+    u8g2_BuildGlyphIndex(&(u8g2->glyph_index), u8g2->font, buf, len);
+}
+
+static const uint8_t *u8g2_font_get_indexed_glyph_data(const u8g2_glyph_index_t *index, const uint8_t *font, uint16_t encoding)
+{
+  uint16_t pos;
+  
+  if ( encoding <= 255 )
+  {
+    pos = encoding - index->first;	/* wraps around below the first glyph */
+    if ( pos >= index->cnt )
+      return NULL;
+    pos = index->table[pos];
+    if ( pos == 0 )
+      return NULL;
+    return font + pos - 1 + 2;	/* skip encoding and glyph size */
+  }
+#ifdef U8G2_WITH_UNICODE
+  else
+  {
+    const uint16_t *pairs = index->table + index->cnt;
+    uint16_t lo = 0;
+    uint16_t hi = index->unicode_cnt;
+    while ( lo < hi )
+    {
+      pos = (lo + hi) >> 1;
+      if ( pairs[2*pos] == encoding )
+	return font + pairs[2*pos+1] + 3;	/* skip encoding and glyph size */
+      if ( pairs[2*pos] < encoding )
+	lo = pos + 1;
+      else
+	hi = pos;
+    }
+  }
+#endif
+  return NULL;
+}
+#endif /* U8G2_WITH_GLYPH_INDEX */
+
 /*
   Description:
     Find the starting point of the glyph data.
@@ -784,6 +914,10 @@ const uint8_t *u8g2_font_get_glyph_data(u8g2_t *u8g2, uint16_t encoding)
   const uint8_t *font = u8g2->font;
   font += U8G2_FONT_DATA_STRUCT_SIZE;
 
+#ifdef U8G2_WITH_GLYPH_INDEX
+  if ( u8g2->glyph_index.font == u8g2->font && u8g2->font != NULL )
+    return u8g2_font_get_indexed_glyph_data(&(u8g2->glyph_index), font, encoding);
+#endif
   
   if ( encoding <= 255 )
   {
@@ -1287,6 +1421,10 @@ void u8g2_SetFont(u8g2_t *u8g2, const uint8_t  *font)
     u8g2->font = font;
     u8g2_read_font_info(&(u8g2->font_info), font);
     u8g2_UpdateRefHeight(u8g2);
+#ifdef U8G2_WITH_GLYPH_INDEX
+    if ( u8g2->glyph_index_buf != NULL )
+      u8g2_BuildGlyphIndex(&(u8g2->glyph_index), font, u8g2->glyph_index_buf, u8g2->glyph_index_buf_len);
+#endif
     /* u8g2_SetFontPosBaseline(u8g2); */ /* removed with issue 195 */
   }
 }
@@ -89,6 +89,17 @@ void u8g2_SetupBuffer(u8g2_t *u8g2, uint8_t *buf, uint8_t tile_buf_height, u8g2_
   u8g2->draw_color = 1;
   u8g2->is_auto_page_clear = 1;
   
+#ifdef U8G2_WITH_SPAN_FILL
+  u8g2->disc_extent.rx = 0x0ff;
+  u8g2->ellipse_extent.rx = 0x0ff;
+#endif /* U8G2_WITH_SPAN_FILL */
+
+#ifdef U8G2_WITH_GLYPH_INDEX
+  u8g2->glyph_index.font = NULL;
+  u8g2->glyph_index_buf = NULL;
+  u8g2->glyph_index_buf_len = 0;
+#endif /* U8G2_WITH_GLYPH_INDEX */
+
   u8g2->cb = u8g2_cb;
   u8g2->cb->update_dimension(u8g2);
 #ifdef U8G2_WITH_CLIP_WINDOW_SUPPORT
@@ -0,0 +1,668 @@
+/*
+
+  u8g2_span.c
+  
+  Universal 8bit Graphics Library (https://github.com/olikraus/u8g2/)
+
+  Copyright (c) 2016, olikraus@gmail.com
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without modification, 
+  are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this list 
+    of conditions and the following disclaimer.
+    
+  * Redistributions in binary form must reproduce the above copyright notice, this 
+    list of conditions and the following disclaimer in the documentation and/or other 
+    materials provided with the distribution.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND 
+  CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, 
+  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF 
+  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE 
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR 
+  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, 
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT 
+  NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; 
+  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, 
+  STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF 
+  ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.  
+
+
+  Area fill for the vertical_top_lsb buffer (SSD13xx, SH1106, UC17xx).
+  
+  A filled shape drawn with hvlines costs one call per pixel row, and every
+  call touches each byte of the row for a single bit. The procedures here 
+  take the whole shape: all rows within one page are combined into one
+  mask, and each page row of the buffer is written once. Runs of 4 bytes
+  are written as aligned 32 bit words, a page which is completely covered
+  is a plain word store.
+  
+  Shapes are given as a list of spans, one span per pixel row. Rounded
+  boxes, discs and filled ellipses are converted to spans: the half width
+  of each row is derived once per radius from the same midpoint steps as 
+  u8g2_circle.c, so the result has exactly the pixels of the hvline version.
+  
+  Only used for U8G2_R0 with u8g2_ll_hvline_vertical_top_lsb, 
+  everything else is drawn with hvlines.
+
+*/
+
+#include "u8g2.h"
+#include <string.h>
+
+#ifdef U8G2_WITH_SPAN_FILL
+
+#ifdef __GNUC__
+typedef uint32_t __attribute__((__may_alias__)) u8g2_span_word_t;
+#else
+typedef uint32_t u8g2_span_word_t;
+#endif
+
+/*
+  Same as u8g2_clip_intersection2() from u8g2_hvline.c, but for a range from 
+  a (included) to b (excluded).
+  returns 0 if there is no intersection with c (included) to d (excluded)
+*/
+static uint8_t u8g2_span_clip(u8g2_uint_t *ap, u8g2_uint_t *bp, u8g2_uint_t c, u8g2_uint_t d)
+{
+  u8g2_uint_t a = *ap;
+  u8g2_uint_t b = *bp;
+  
+  if ( a > b )
+  {
+    if ( a < d )
+    {
+      b = d;
+      b--;
+    }
+    else
+    {
+      a = c;
+    }
+  }
+  if ( a >= d )
+    return 0;
+  if ( b <= c )
+    return 0;
+  if ( a < c )
+    a = c;
+  if ( b > d )
+    b = d;
+  *ap = a;
+  *bp = b;
+  return 1;
+}
+
+static uint8_t u8g2_is_span_fill(u8g2_t *u8g2)
+{
+  if ( u8g2->ll_hvline != u8g2_ll_hvline_vertical_top_lsb )
+    return 0;
+  if ( u8g2->cb != U8G2_R0 )
+    return 0;
+  return 1;
+}
+
+/*
+  Apply mask to len bytes starting at ptr, with the current draw color.
+  len may be 0
+*/
+static void u8g2_span_fill_bytes(u8g2_t *u8g2, uint8_t *ptr, u8g2_uint_t len, uint8_t mask)
+{
+  uint8_t or_mask, xor_mask;
+  
+  /* see u8g2_ll_hvline.c */
+  or_mask = 0;
+  xor_mask = 0;
+  if ( u8g2->draw_color <= 1 )
+    or_mask  = mask;
+  if ( u8g2->draw_color != 1 )
+    xor_mask = mask;
+  
+  /* unaligned head */
+  while( len != 0 && ((uintptr_t)ptr & 3) != 0 )
+  {
+    *ptr |= or_mask;
+    *ptr ^= xor_mask;
+    ptr++;
+    len--;
+  }
+  
+  if ( len >= 4 )
+  {
+    u8g2_span_word_t *wptr = (u8g2_span_word_t *)ptr;
+    uint32_t or_word = or_mask * 0x01010101UL;
+    uint32_t xor_word = xor_mask * 0x01010101UL;
+    
+    if ( or_mask == 0x0ff )
+    {
+      /* complete page row, the result does not depend on the buffer */
+      uint32_t word = or_word ^ xor_word;
+      do
+      {
+	*wptr++ = word;
+	len -= 4;
+      } while( len >= 4 );
+    }
+    else
+    {
+      do
+      {
+	*wptr = (*wptr | or_word) ^ xor_word;
+	wptr++;
+	len -= 4;
+      } while( len >= 4 );
+    }
+    ptr = (uint8_t *)wptr;
+  }
+  
+  /* tail */
+  while( len != 0 )
+  {
+    *ptr |= or_mask;
+    *ptr ^= xor_mask;
+    ptr++;
+    len--;
+  }
+}
+
+/* first byte of page row for the buffer row y (not the display row) */
+static uint8_t *u8g2_span_page_ptr(u8g2_t *u8g2, u8g2_uint_t y)
+{
+  uint16_t offset;
+  
+  offset = y;
+  offset >>= 3;
+  offset *= u8g2->pixel_buf_width;
+  return u8g2->tile_buf_ptr + offset;
+}
+
+/*
+  Fill a box, x0,y0 included, x1,y1 excluded.
+  returns 0 if the buffer is not supported, the box has to be drawn with hvlines then
+*/
+uint8_t u8g2_span_fill_box(u8g2_t *u8g2, u8g2_uint_t x0, u8g2_uint_t y0, u8g2_uint_t x1, u8g2_uint_t y1)
+{
+  uint8_t mask;
+  
+  if ( u8g2_is_span_fill(u8g2) == 0 )
+    return 0;
+  
+#ifdef U8G2_WITH_CLIP_WINDOW_SUPPORT
+  if ( u8g2->is_page_clip_window_intersection == 0 )
+    return 1;
+#endif /* U8G2_WITH_CLIP_WINDOW_SUPPORT */
+  if ( u8g2_span_clip(&x0, &x1, u8g2->user_x0, u8g2->user_x1) == 0 )
+    return 1;
+  if ( u8g2_span_clip(&y0, &y1, u8g2->user_y0, u8g2->user_y1) == 0 )
+    return 1;
+  
+  /* transform to pixel buffer coordinates */
+  y0 -= u8g2->pixel_curr_row;
+  y1 -= u8g2->pixel_curr_row;
+  
+  mask = 0x0ff << (y0 & 7);
+  for(;;)
+  {
+    uint8_t *ptr = u8g2_span_page_ptr(u8g2, y0) + x0;
+    u8g2_uint_t page_end = (y0 | 7) + 1;
+    
+    if ( y1 <= page_end )
+    {
+      mask &= 0x0ff >> (page_end - y1);
+      u8g2_span_fill_bytes(u8g2, ptr, x1 - x0, mask);
+      break;
+    }
+    u8g2_span_fill_bytes(u8g2, ptr, x1 - x0, mask);
+    y0 = page_end;
+    mask = 0x0ff;
+  }
+  return 1;
+}
+
+/*
+  Draw h rows starting at y, row y+i is filled from spans[i].x0 (included)
+  to spans[i].x1 (excluded). Rows with x0 == x1 are empty.
+  
+  Within a page, the columns covered by all rows of the page are filled
+  with one combined mask, only the remaining ends of each row are written
+  bit by bit.
+*/
+void u8g2_DrawSpans(u8g2_t *u8g2, u8g2_uint_t y, u8g2_uint_t h, const u8g2_span_t *spans)
+{
+  u8g2_uint_t y0, y1;
+  
+  if ( h == 0 )
+    return;
+  
+  if ( u8g2_is_span_fill(u8g2) == 0 )
+  {
+    do
+    {
+      if ( spans->x0 != spans->x1 )
+	u8g2_DrawHVLine(u8g2, spans->x0, y, spans->x1 - spans->x0, 0);
+      spans++;
+      y++;
+      h--;
+    } while( h != 0 );
+    return;
+  }
+  
+#ifdef U8G2_WITH_CLIP_WINDOW_SUPPORT
+  if ( u8g2->is_page_clip_window_intersection == 0 )
+    return;
+#endif /* U8G2_WITH_CLIP_WINDOW_SUPPORT */
+  y0 = y;
+  y1 = y + h;
+  if ( y1 < y0 )
+  {
+    /* negative y, skip the rows above the display */
+    spans += (u8g2_uint_t)(0 - y0);
+    y0 = 0;
+  }
+  if ( y1 > u8g2->user_y1 )
+    y1 = u8g2->user_y1;
+  if ( y0 < u8g2->user_y0 )
+  {
+    spans += u8g2->user_y0 - y0;
+    y0 = u8g2->user_y0;
+  }
+  if ( y0 >= y1 )
+    return;
+  
+  while( y0 < y1 )
+  {
+    u8g2_uint_t x0[8], x1[8];
+    u8g2_uint_t cx0, cx1;
+    u8g2_uint_t row = y0 - u8g2->pixel_curr_row;
+    uint8_t *page_ptr = u8g2_span_page_ptr(u8g2, row);
+    uint8_t bit = row & 7;
+    uint8_t first = bit;
+    uint8_t last;
+    uint8_t mask = 0;
+    
+    /* clip the rows of this page and find the columns common to all of them */
+    cx0 = u8g2->user_x1;
+    cx1 = u8g2->user_x0;
+    do
+    {
+      x0[bit] = spans->x0;
+      x1[bit] = spans->x1;
+      if ( x0[bit] != x1[bit] && u8g2_span_clip(x0 + bit, x1 + bit, u8g2->user_x0, u8g2->user_x1) != 0 )
+      {
+	if ( mask == 0 || x0[bit] > cx0 )
+	  cx0 = x0[bit];
+	if ( mask == 0 || x1[bit] < cx1 )
+	  cx1 = x1[bit];
+	mask |= 1 << bit;
+      }
+      else
+      {
+	x1[bit] = x0[bit];
+      }
+      spans++;
+      y0++;
+      bit++;
+    } while( bit < 8 && y0 < y1 );
+    last = bit;
+    
+    if ( mask == 0 )
+      continue;
+    
+    if ( cx0 < cx1 )
+    {
+      u8g2_span_fill_bytes(u8g2, page_ptr + cx0, cx1 - cx0, mask);
+      for( bit = first; bit < last; bit++ )
+      {
+	if ( x0[bit] >= x1[bit] )
+	  continue;
+	if ( x0[bit] < cx0 )
+	  u8g2_span_fill_bytes(u8g2, page_ptr + x0[bit], cx0 - x0[bit], 1 << bit);
+	if ( x1[bit] > cx1 )
+	  u8g2_span_fill_bytes(u8g2, page_ptr + cx1, x1[bit] - cx1, 1 << bit);
+      }
+    }
+    else
+    {
+      for( bit = first; bit < last; bit++ )
+      {
+	if ( x0[bit] < x1[bit] )
+	  u8g2_span_fill_bytes(u8g2, page_ptr + x0[bit], x1[bit] - x0[bit], 1 << bit);
+      }
+    }
+  }
+}
+
+/*==========================================================*/
+/* span rasterizer */
+
+/*
+  The filled shapes of u8g2_box.c and u8g2_circle.c are unions of vertical 
+  lines, one per column, symmetric to the center. The midpoint steps give 
+  the height of each column, the extent tables record for each row dy away 
+  from the center the outermost column reaching it.
+  
+  Each row is one span only if the column heights never increase outwards
+  and no column is skipped. Very flat ellipses have gaps, these get 
+  hw[0] = 0x0ff and are drawn with hvlines.
+*/
+
+static void u8g2_span_column(u8g2_span_extent_t *e, uint8_t *height, u8g2_uint_t x, u8g2_uint_t y)
+{
+  if ( x > e->rx || y > e->ry )
+  {
+    e->hw[0] = 0x0ff;		/* not covered by the table */
+    return;
+  }
+  if ( height[x] == 0x0ff || y > height[x] )
+    height[x] = y;
+}
+
+static void u8g2_span_extent_finish(u8g2_span_extent_t *e, const uint8_t *height)
+{
+  uint8_t x, dy;
+  
+  if ( e->hw[0] == 0x0ff )
+    return;
+  if ( height[0] != e->ry )
+  {
+    e->hw[0] = 0x0ff;
+    return;
+  }
+  for( x = 0; x <= e->rx; x++ )
+  {
+    if ( height[x] == 0x0ff || (x > 0 && height[x] > height[x-1]) )
+    {
+      e->hw[0] = 0x0ff;
+      return;
+    }
+    e->hw[height[x]] = x;
+  }
+  /* columns reaching row dy also reach all rows closer to the center */
+  for( dy = e->ry; dy > 0; dy-- )
+    if ( e->hw[dy-1] < e->hw[dy] )
+      e->hw[dy-1] = e->hw[dy];
+}
+
+/* same steps as u8g2_draw_disc() */
+static const uint8_t *u8g2_span_disc_extent(u8g2_t *u8g2, u8g2_uint_t rad)
+{
+  u8g2_span_extent_t *e = &(u8g2->disc_extent);
+  uint8_t height[U8G2_SPAN_MAX_RADIUS+1];
+  u8g2_int_t f;
+  u8g2_int_t ddF_x;
+  u8g2_int_t ddF_y;
+  u8g2_uint_t x;
+  u8g2_uint_t y;
+  
+  if ( e->rx == rad )
+    return e->hw;
+  
+  e->rx = rad;
+  e->ry = rad;
+  memset(e->hw, 0, rad+1);
+  memset(height, 0x0ff, rad+1);
+  
+  f = 1;
+  f -= rad;
+  ddF_x = 1;
+  ddF_y = 0;
+  ddF_y -= rad;
+  ddF_y *= 2;
+  x = 0;
+  y = rad;
+
+  u8g2_span_column(e, height, x, y);
+  u8g2_span_column(e, height, y, x);
+  
+  while ( x < y )
+  {
+    if (f >= 0) 
+    {
+      y--;
+      ddF_y += 2;
+      f += ddF_y;
+    }
+    x++;
+    ddF_x += 2;
+    f += ddF_x;
+    u8g2_span_column(e, height, x, y);
+    u8g2_span_column(e, height, y, x);
+  }
+  u8g2_span_extent_finish(e, height);
+  return e->hw;
+}
+
+/* same steps as u8g2_draw_filled_ellipse() */
+static const uint8_t *u8g2_span_ellipse_extent(u8g2_t *u8g2, u8g2_uint_t rx, u8g2_uint_t ry)
+{
+  u8g2_span_extent_t *e = &(u8g2->ellipse_extent);
+  uint8_t height[U8G2_SPAN_MAX_RX+1];
+  u8g2_uint_t x, y;
+  u8g2_long_t xchg, ychg;
+  u8g2_long_t err;
+  u8g2_long_t rxrx2;
+  u8g2_long_t ryry2;
+  u8g2_long_t stopx, stopy;
+  
+  if ( e->rx == rx && e->ry == ry )
+    return e->hw;
+  
+  e->rx = rx;
+  e->ry = ry;
+  memset(e->hw, 0, ry+1);
+  memset(height, 0x0ff, rx+1);
+  
+  rxrx2 = rx;
+  rxrx2 *= rx;
+  rxrx2 *= 2;
+  
+  ryry2 = ry;
+  ryry2 *= ry;
+  ryry2 *= 2;
+  
+  x = rx;
+  y = 0;
+  
+  xchg = 1;
+  xchg -= rx;
+  xchg -= rx;
+  xchg *= ry;
+  xchg *= ry;
+  
+  ychg = rx;
+  ychg *= rx;
+  
+  err = 0;
+  
+  stopx = ryry2;
+  stopx *= rx;
+  stopy = 0;
+  
+  while( stopx >= stopy )
+  {
+    u8g2_span_column(e, height, x, y);
+    y++;
+    stopy += rxrx2;
+    err += ychg;
+    ychg += rxrx2;
+    if ( 2*err+xchg > 0 )
+    {
+      x--;
+      stopx -= ryry2;
+      err += xchg;
+      xchg += ryry2;      
+    }
+  }
+
+  x = 0;
+  y = ry;
+  
+  xchg = ry;
+  xchg *= ry;
+  
+  ychg = 1;
+  ychg -= ry;
+  ychg -= ry;
+  ychg *= rx;
+  ychg *= rx;
+  
+  err = 0;
+  
+  stopx = 0;
+
+  stopy = rxrx2;
+  stopy *= ry;
+
+  while( stopx <= stopy )
+  {
+    u8g2_span_column(e, height, x, y);
+    x++;
+    stopx += ryry2;
+    err += xchg;
+    xchg += ryry2;
+    if ( 2*err+ychg > 0 )
+    {
+      y--;
+      stopy -= rxrx2;
+      err += ychg;
+      ychg += rxrx2;
+    }
+  }
+  u8g2_span_extent_finish(e, height);
+  return e->hw;
+}
+
+/*
+  Draw the h rows starting at y of a shape with the upper quarters centered 
+  at xl/xr in row y+r and the lower quarters centered at xl/xr in row y+h-1-r. 
+  Rows between them are as wide as the center row. xl <= xr, h >= 2*r.
+  option selects the quarters as for u8g2_DrawDisc(), a quarter includes
+  its center row and column.
+  
+  The spans are passed on page by page.
+*/
+static void u8g2_span_draw_round(u8g2_t *u8g2, u8g2_uint_t xl, u8g2_uint_t xr, u8g2_uint_t y, u8g2_uint_t h, u8g2_uint_t r, const uint8_t *hw, uint8_t option)
+{
+  u8g2_span_t spans[8];
+  u8g2_uint_t lower = h - 1 - r;	/* first row of the lower quarters */
+  u8g2_uint_t i;
+  uint8_t n = 0;
+  
+  for( i = 0; i < h; i++ )
+  {
+    u8g2_uint_t w = hw[0];
+    uint8_t left = 0, right = 0;
+    
+    if ( i <= r )
+    {
+      w = hw[r - i];
+      if ( option & U8G2_DRAW_UPPER_LEFT )
+	left = 1;
+      if ( option & U8G2_DRAW_UPPER_RIGHT )
+	right = 1;
+    }
+    if ( i >= lower )
+    {
+      if ( hw[i - lower] > w || i > r )
+	w = hw[i - lower];
+      if ( option & U8G2_DRAW_LOWER_LEFT )
+	left = 1;
+      if ( option & U8G2_DRAW_LOWER_RIGHT )
+	right = 1;
+    }
+    if ( i > r && i < lower )
+    {
+      left = 1;
+      right = 1;
+    }
+    
+    spans[n].x0 = xl;
+    spans[n].x1 = xr + 1;
+    if ( left == 0 && right == 0 )
+      spans[n].x1 = xl;
+    if ( left != 0 )
+      spans[n].x0 -= w;
+    if ( right != 0 )
+      spans[n].x1 += w;
+    n++;
+    
+    if ( n == 8 || ((y + i + 1) & 7) == 0 || i + 1 == h )
+    {
+      u8g2_DrawSpans(u8g2, y + i + 1 - n, n, spans);
+      n = 0;
+    }
+  }
+}
+
+/* hvlines overlap in the shapes below, their xor result is kept */
+static uint8_t u8g2_is_span_shape(u8g2_t *u8g2)
+{
+  if ( u8g2_is_span_fill(u8g2) == 0 )
+    return 0;
+  if ( u8g2->draw_color > 1 )
+    return 0;
+  return 1;
+}
+
+/*
+  returns 0 if the rounded box has to be drawn as in u8g2_box.c
+*/
+uint8_t u8g2_span_rbox(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t y, u8g2_uint_t w, u8g2_uint_t h, u8g2_uint_t r)
+{
+  const uint8_t *hw;
+  
+  if ( u8g2_is_span_shape(u8g2) == 0 )
+    return 0;
+  if ( r > U8G2_SPAN_MAX_RADIUS )
+    return 0;
+  /* narrower or lower boxes have overlapping corners, left to the original */
+  if ( w <= 2*r || h < 2*r || h == 0 )
+    return 0;
+  hw = u8g2_span_disc_extent(u8g2, r);
+  if ( hw[0] == 0x0ff )
+    return 0;
+  u8g2_span_draw_round(u8g2, x + r, x + w - r - 1, y, h, r, hw, U8G2_DRAW_ALL);
+  return 1;
+}
+
+/*
+  returns 0 if the disc has to be drawn as in u8g2_circle.c
+*/
+uint8_t u8g2_span_disc(u8g2_t *u8g2, u8g2_uint_t x0, u8g2_uint_t y0, u8g2_uint_t rad, uint8_t option)
+{
+  const uint8_t *hw;
+  
+  if ( u8g2_is_span_shape(u8g2) == 0 )
+    return 0;
+  if ( rad > U8G2_SPAN_MAX_RADIUS )
+    return 0;
+  hw = u8g2_span_disc_extent(u8g2, rad);
+  if ( hw[0] == 0x0ff )
+    return 0;
+  u8g2_span_draw_round(u8g2, x0, x0, y0 - rad, 2*rad + 1, rad, hw, option);
+  return 1;
+}
+
+/*
+  returns 0 if the ellipse has to be drawn as in u8g2_circle.c
+*/
+uint8_t u8g2_span_filled_ellipse(u8g2_t *u8g2, u8g2_uint_t x0, u8g2_uint_t y0, u8g2_uint_t rx, u8g2_uint_t ry, uint8_t option)
+{
+  const uint8_t *hw;
+  
+  if ( u8g2_is_span_shape(u8g2) == 0 )
+    return 0;
+  if ( rx > U8G2_SPAN_MAX_RX || ry > U8G2_SPAN_MAX_RADIUS )
+    return 0;
+  hw = u8g2_span_ellipse_extent(u8g2, rx, ry);
+  if ( hw[0] == 0x0ff )
+    return 0;
+  u8g2_span_draw_round(u8g2, x0, x0, y0 - ry, 2*ry + 1, ry, hw, option);
+  return 1;
+}
+
+#endif /* U8G2_WITH_SPAN_FILL */
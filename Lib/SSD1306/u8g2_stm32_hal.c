@@ -9,13 +9,94 @@
 
 #include <string.h>
 
+#include "FreeRTOS.h"
 #include "main.h"
+#include "task.h"
+#include "trace.h"
 
 #define SSD1306_I2C_ADDRESS 0x78
-#define MAX_I2C_BUFFER_SIZE 1025
 
-static uint8_t i2c_buffer[MAX_I2C_BUFFER_SIZE];
-static uint16_t i2c_buffer_index = 0;
+/*
+ * Scatter transfer for u8x8: a transfer is a list of segments which are sent as
+ * one I2C transaction (sequential transmit, no repeated START in between).
+ * Short sends (control bytes, commands and their arguments, passed by u8x8 as
+ * pointers to temporaries) are copied into a small inline buffer, longer sends
+ * (tile data) are referenced in place. The segments are chained in the transfer
+ * complete interrupt.
+ */
+#define I2C_MAX_SEGMENTS 8
+#define I2C_INLINE_SIZE 32
+#define I2C_INLINE_MAX_SEND 4  // sends up to this length are copied
+
+typedef struct {
+  const uint8_t* ptr;
+  uint16_t len;
+} i2c_segment_t;
+
+static i2c_segment_t i2c_segments[I2C_MAX_SEGMENTS];
+static uint8_t i2c_segment_cnt = 0;
+static volatile uint8_t i2c_segment_idx = 0;
+static uint8_t i2c_inline[I2C_INLINE_SIZE];
+static uint8_t i2c_inline_len = 0;
+static volatile uint8_t i2c_chain_active = 0;
+
+/*
+ * Tile streaming: every span of tiles is sent as one I2C transaction, a command
+ * prefix (column and page address, Co=1 control bytes, followed by the data
+ * control byte) and the payload, read in place. Spans are queued by the display
+ * task and both parts of each are chained in the transfer complete interrupt,
+ * the display task is not woken up between them.
+ *
+ * Every span gets a fence, the spans of the fences after stream_fence_done up
+ * to stream_fence_issued are queued, the one of fence f in stream_spans[f % SH1106_MAX_SPANS].
+ */
+#define SH1106_MAX_SPANS 8  // one row of tiles of each page of the display
+#define SH1106_PREFIX_SIZE 7
+
+typedef struct {
+  const uint8_t* tiles;
+  uint8_t page;
+  uint8_t tx;
+  uint8_t tw;
+} sh1106_span_t;
+
+typedef enum {
+  STREAM_IDLE = 0,
+  STREAM_PREFIX,
+  STREAM_PAYLOAD,
+} stream_phase_t;
+
+static sh1106_span_t stream_spans[SH1106_MAX_SPANS];
+static uint8_t stream_prefix[SH1106_PREFIX_SIZE];
+static uint8_t stream_x_offset = 0;
+static volatile stream_phase_t stream_phase = STREAM_IDLE;
+static volatile uint8_t stream_error = 0;
+static volatile u8g2_fence_t stream_fence_issued = 0;
+static volatile u8g2_fence_t stream_fence_done = 0;
+
+static void sh1106_stream_wait(u8g2_fence_t fence, uint32_t timeout);
+
+/**
+ * @brief  Start the DMA transfer of the current segment of a u8x8 transfer.
+ * @retval HAL status
+ */
+static HAL_StatusTypeDef i2c_chain_next(void) {
+  const i2c_segment_t* seg = &i2c_segments[i2c_segment_idx];
+  uint8_t first = (i2c_segment_idx == 0);
+  uint8_t last = (i2c_segment_idx + 1 == i2c_segment_cnt);
+  uint32_t options;
+
+  if (first && last) {
+    options = I2C_FIRST_AND_LAST_FRAME;
+  } else if (first) {
+    options = I2C_FIRST_FRAME;
+  } else if (last) {
+    options = I2C_LAST_FRAME;
+  } else {
+    options = I2C_NEXT_FRAME;
+  }
+  return HAL_I2C_Master_Seq_Transmit_DMA(&hi2c1, SSD1306_I2C_ADDRESS, (uint8_t*)seg->ptr, seg->len, options);
+}
 
 uint8_t u8x8_byte_stm32_hw_i2c(u8x8_t* u8x8, uint8_t msg, uint8_t arg_int, void* arg_ptr) {
   switch (msg) {
@@ -29,25 +110,46 @@ uint8_t u8x8_byte_stm32_hw_i2c(u8x8_t* u8x8, uint8_t msg, uint8_t arg_int, void*
       break;
 
     case U8X8_MSG_BYTE_START_TRANSFER:
-      i2c_buffer_index = 0;  // 重置缓冲区索引
+      // 等待排队的图块发送完, I2C 总线空闲后才能开始新的传输
+      sh1106_stream_wait(stream_fence_issued, osWaitForever);
+      i2c_segment_cnt = 0;
+      i2c_inline_len = 0;
       break;
 
     case U8X8_MSG_BYTE_SEND:
-      // 将数据拷贝到 DMA 缓冲区
-      if (i2c_buffer_index + arg_int <= MAX_I2C_BUFFER_SIZE) {
-        memcpy(&i2c_buffer[i2c_buffer_index], arg_ptr, arg_int);
-        i2c_buffer_index += arg_int;
+      if (arg_int == 0) {
+        break;
+      }
+      if (arg_int <= I2C_INLINE_MAX_SEND && i2c_inline_len + arg_int <= I2C_INLINE_SIZE) {
+        // 短数据 (控制字节/命令) 拷贝到内联缓冲区, 与上一个内联段相邻时直接合并
+        uint8_t* dst = &i2c_inline[i2c_inline_len];
+        memcpy(dst, arg_ptr, arg_int);
+        i2c_inline_len += arg_int;
+        if (i2c_segment_cnt > 0 && i2c_segments[i2c_segment_cnt - 1].ptr + i2c_segments[i2c_segment_cnt - 1].len == dst) {
+          i2c_segments[i2c_segment_cnt - 1].len += arg_int;
+          break;
+        }
+        arg_ptr = dst;
       }
+      // 长数据直接引用, 传输在 END_TRANSFER 中同步完成, 指针在此之前一直有效
+      if (i2c_segment_cnt >= I2C_MAX_SEGMENTS) {
+        return 0;
+      }
+      i2c_segments[i2c_segment_cnt].ptr = arg_ptr;
+      i2c_segments[i2c_segment_cnt].len = arg_int;
+      i2c_segment_cnt++;
       break;
 
     case U8X8_MSG_BYTE_END_TRANSFER:
-      // 使用 DMA 发送整个累积的缓冲区
-      if (i2c_buffer_index > 0) {
-        // 启动 DMA 传输
-        if (HAL_I2C_Master_Transmit_DMA(&hi2c1, SSD1306_I2C_ADDRESS, i2c_buffer, i2c_buffer_index) != HAL_OK) {
-          // DMA 启动失败，可以在这里处理错误
-          // 例如，可以尝试使用阻塞模式作为备用方案
-          // HAL_I2C_Master_Transmit(&hi2c1, SSD1306_I2C_ADDRESS, i2c_buffer, i2c_buffer_index, HAL_MAX_DELAY);
+      if (i2c_segment_cnt > 0) {
+        // 清除上一次传输遗留的信号量
+        osSemaphoreAcquire(i2cDmaSemaphoreHandle, 0);
+
+        // 启动第一段的 DMA 传输, 其余各段在传输完成中断中依次发送
+        i2c_segment_idx = 0;
+        i2c_chain_active = 1;
+        if (i2c_chain_next() != HAL_OK) {
+          i2c_chain_active = 0;
           return 0;  // 表示失败
         }
 
@@ -67,6 +169,126 @@ uint8_t u8x8_byte_stm32_hw_i2c(u8x8_t* u8x8, uint8_t msg, uint8_t arg_int, void*
   return 1;
 }
 
+/**
+ * @brief  Start the next transfer of the tile stream.
+ * @note   Called from the display task for the first span of an idle stream
+ *         and from the transfer complete interrupt for all following parts.
+ * @retval HAL status
+ */
+static HAL_StatusTypeDef sh1106_stream_next(void) {
+  const sh1106_span_t* span = &stream_spans[(stream_fence_done + 1) % SH1106_MAX_SPANS];
+
+  if (stream_phase == STREAM_PREFIX) {
+    uint8_t x = span->tx * 8 + stream_x_offset;
+
+    stream_prefix[0] = 0x80;  // Co=1, D/C#=0: single command byte follows
+    stream_prefix[1] = 0x10 | (x >> 4);
+    stream_prefix[2] = 0x80;
+    stream_prefix[3] = x & 0x0F;
+    stream_prefix[4] = 0x80;
+    stream_prefix[5] = 0xB0 | span->page;
+    stream_prefix[6] = 0x40;  // Co=0, D/C#=1: data until STOP
+    return HAL_I2C_Master_Seq_Transmit_DMA(&hi2c1, SSD1306_I2C_ADDRESS, stream_prefix, SH1106_PREFIX_SIZE,
+                                           I2C_FIRST_FRAME);
+  }
+
+  return HAL_I2C_Master_Seq_Transmit_DMA(&hi2c1, SSD1306_I2C_ADDRESS, (uint8_t*)span->tiles, span->tw * 8,
+                                         I2C_LAST_FRAME);
+}
+
+/**
+ * @brief  Drop the queued spans after an error, their fences are reached.
+ * @retval None
+ */
+static void sh1106_stream_abort(void) {
+  stream_phase = STREAM_IDLE;
+  stream_error = 1;
+  stream_fence_done = stream_fence_issued;
+  osSemaphoreRelease(i2cDmaSemaphoreHandle);
+}
+
+/**
+ * @brief  Advance the tile stream, called from the transfer complete interrupt.
+ * @retval None
+ */
+static void sh1106_stream_advance(void) {
+  if (stream_phase == STREAM_PREFIX) {
+    stream_phase = STREAM_PAYLOAD;
+  } else {
+    // The span is on the display, a task waiting for its fence can reuse the tiles
+    stream_fence_done++;
+    stream_phase = stream_fence_done != stream_fence_issued ? STREAM_PREFIX : STREAM_IDLE;
+    osSemaphoreRelease(i2cDmaSemaphoreHandle);
+  }
+
+  if (stream_phase != STREAM_IDLE && sh1106_stream_next() != HAL_OK) {
+    sh1106_stream_abort();
+  }
+}
+
+static void sh1106_stream_wait(u8g2_fence_t fence, uint32_t timeout) {
+  while ((int32_t)(stream_fence_done - fence) < 0) {
+    if (osSemaphoreAcquire(i2cDmaSemaphoreHandle, timeout) != osOK) {
+      return;
+    }
+  }
+}
+
+/**
+ * @brief  Queue a row of tiles for a SH1106 display and return without waiting
+ *         for the transfer.
+ * @note   The tiles are sent from where they are and must not be modified
+ *         before the fence has been reached. Waits for a free slot if
+ *         SH1106_MAX_SPANS spans are queued.
+ * @param  u8g2: U8g2 structure pointer
+ * @param  tx: first tile column
+ * @param  ty: tile row, the page of the display
+ * @param  tw: number of tiles
+ * @param  tiles: tw * 8 bytes in u8g2 tile layout
+ * @retval Fence of the tiles, see u8g2_WaitFence_sh1106_dma()
+ */
+u8g2_fence_t u8g2_SendTilesAsync_sh1106_dma(u8g2_t* u8g2, uint8_t tx, uint8_t ty, uint8_t tw, const uint8_t* tiles) {
+  sh1106_stream_wait(stream_fence_issued + 1 - SH1106_MAX_SPANS, osWaitForever);
+
+  sh1106_span_t* span = &stream_spans[(stream_fence_issued + 1) % SH1106_MAX_SPANS];
+  span->tiles = tiles;
+  span->page = ty;
+  span->tx = tx;
+  span->tw = tw;
+  stream_x_offset = u8g2_GetU8x8(u8g2)->x_offset;
+
+  // The interrupt must not see the stream go idle between the check and the start
+  taskENTER_CRITICAL();
+  u8g2_fence_t fence = ++stream_fence_issued;
+  if (stream_phase == STREAM_IDLE) {
+    stream_phase = STREAM_PREFIX;
+    if (sh1106_stream_next() != HAL_OK) {
+      sh1106_stream_abort();
+    }
+  }
+  taskEXIT_CRITICAL();
+  return fence;
+}
+
+/**
+ * @brief  Wait until the tiles of the given fence have been sent.
+ * @param  fence: Fence returned by u8g2_SendTilesAsync_sh1106_dma()
+ * @param  timeout: Timeout in ticks, osWaitForever to block
+ * @retval 1 if the tiles have been sent, 0 on timeout or if tiles were dropped
+ *         after an I2C error since the last wait
+ */
+uint8_t u8g2_WaitFence_sh1106_dma(u8g2_fence_t fence, uint32_t timeout) {
+  sh1106_stream_wait(fence, timeout);
+  if ((int32_t)(stream_fence_done - fence) < 0) {
+    return 0;
+  }
+  if (stream_error) {
+    stream_error = 0;
+    return 0;
+  }
+  return 1;
+}
+
 /**
  * @brief I2C Master Tx Transfer completed callback.
  *        这是 HAL 库在 DMA 传输成功完成后自动调用的中断回调函数。
@@ -75,6 +297,17 @@ uint8_t u8x8_byte_stm32_hw_i2c(u8x8_t* u8x8, uint8_t msg, uint8_t arg_int, void*
  */
 void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef* hi2c) {
   if (hi2c->Instance == hi2c1.Instance) {
+    if (stream_phase != STREAM_IDLE) {
+      sh1106_stream_advance();
+      return;
+    }
+    if (i2c_chain_active) {
+      i2c_segment_idx++;
+      if (i2c_segment_idx < i2c_segment_cnt && i2c_chain_next() == HAL_OK) {
+        return;
+      }
+      i2c_chain_active = 0;
+    }
     osSemaphoreRelease(i2cDmaSemaphoreHandle);
   }
 }
@@ -88,7 +321,12 @@ void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef* hi2c) {
 void HAL_I2C_ErrorCallback(I2C_HandleTypeDef* hi2c) {
   if (hi2c->Instance == hi2c1.Instance) {
     uint32_t error_code = HAL_I2C_GetError(hi2c);
-    UART_Printf(&huart1, "I2C Error: 0x%X\r\n", error_code);
+    TRACE("I2C Error: 0x%lX", error_code);
+    if (stream_phase != STREAM_IDLE) {
+      sh1106_stream_abort();
+      return;
+    }
+    i2c_chain_active = 0;
     osSemaphoreRelease(i2cDmaSemaphoreHandle);
   }
 }
@@ -152,4 +390,14 @@ void u8g2_Setup_ssd1306_i2c_128x64_noname_f_hal(u8g2_t* u8g2, const u8g2_cb_t* r
 
 void u8g2_Setup_sh1106_i2c_128x64_noname_f_hal(u8g2_t* u8g2, const u8g2_cb_t* rotation) {
   u8g2_Setup_sh1106_i2c_128x64_noname_f(u8g2, rotation, u8x8_byte_stm32_hw_i2c, u8x8_gpio_and_delay_stm32);
-}
\ No newline at end of file
+}
+
+/**
+ * @brief  Setup U8g2 for SH1106 128x64 display in page buffer mode, one page of 128 bytes
+ * @param  u8g2: U8g2 structure pointer
+ * @param  rotation: Display rotation callback
+ * @retval None
+ */
+void u8g2_Setup_sh1106_i2c_128x64_noname_1_hal(u8g2_t* u8g2, const u8g2_cb_t* rotation) {
+  u8g2_Setup_sh1106_i2c_128x64_noname_1(u8g2, rotation, u8x8_byte_stm32_hw_i2c, u8x8_gpio_and_delay_stm32);
+}
@@ -18,6 +18,9 @@ extern "C" {
 #include "u8g2.h"
 #include "cmsis_os.h"
 
+/* Exported types ------------------------------------------------------------*/
+typedef uint32_t u8g2_fence_t;
+
 /* External variables --------------------------------------------------------*/
 extern osSemaphoreId_t i2cDmaSemaphoreHandle;
 extern I2C_HandleTypeDef hi2c1;
@@ -28,6 +31,10 @@ uint8_t u8x8_gpio_and_delay_stm32(u8x8_t* u8x8, uint8_t msg, uint8_t arg_int, vo
 
 void u8g2_Setup_ssd1306_i2c_128x64_noname_f_hal(u8g2_t* u8g2, const u8g2_cb_t* rotation);
 void u8g2_Setup_sh1106_i2c_128x64_noname_f_hal(u8g2_t* u8g2, const u8g2_cb_t* rotation);
+void u8g2_Setup_sh1106_i2c_128x64_noname_1_hal(u8g2_t* u8g2, const u8g2_cb_t* rotation);
+
+u8g2_fence_t u8g2_SendTilesAsync_sh1106_dma(u8g2_t* u8g2, uint8_t tx, uint8_t ty, uint8_t tw, const uint8_t* tiles);
+uint8_t u8g2_WaitFence_sh1106_dma(u8g2_fence_t fence, uint32_t timeout);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,128 @@
+# Per-object RAM usage from a GNU ld map file
+#
+#   cmake -DMAP_FILE=stm32-dev.map -DOUTPUT_FILE=stm32-dev.ram.txt -P ram_report.cmake
+#
+# Lists every input section placed in RAM (0x20000000, see STM32F103XX_FLASH.ld),
+# largest first. With -fdata-sections each variable has its own .data.<name> or
+# .bss.<name> section, so the rows are single objects: task stacks, control
+# blocks, queue storage, driver state. Sections without a name suffix are
+# reported by the file they come from. The reserved heap and stack of
+# ._user_heap_stack are listed as well, the totals match --print-memory-usage.
+
+if(NOT MAP_FILE OR NOT OUTPUT_FILE)
+    message(FATAL_ERROR "usage: cmake -DMAP_FILE=<map> -DOUTPUT_FILE=<txt> -P ram_report.cmake")
+endif()
+
+set(RAM_ORIGIN 0x20000000)
+set(RAM_LENGTH 20480)
+
+file(READ "${MAP_FILE}" map)
+# Square brackets and semicolons would break the CMake list split
+string(REPLACE ";" "," map "${map}")
+string(REPLACE "[" "(" map "${map}")
+string(REPLACE "]" ")" map "${map}")
+# Only the memory map part, the discarded sections come before it
+string(FIND "${map}" "Linker script and memory map" start)
+if(start GREATER -1)
+    string(SUBSTRING "${map}" ${start} -1 map)
+endif()
+# ld puts the address on the next line when the section name is long
+string(REGEX REPLACE "\n( ?[^ \n]+)\n +0x" "\n\\1 0x" map "${map}")
+string(REPLACE "\n" ";" lines "${map}")
+
+math(EXPR ram_end "${RAM_ORIGIN} + ${RAM_LENGTH}" OUTPUT_FORMAT DECIMAL)
+set(rows "")
+set(output_section "")
+set(total 0)
+
+foreach(line IN LISTS lines)
+    # Output section: name at column 0
+    if(line MATCHES "^([._A-Za-z][^ ]*) +0x([0-9a-fA-F]+) +0x([0-9a-fA-F]+)")
+        set(output_section "${CMAKE_MATCH_1}")
+        math(EXPR address "0x${CMAKE_MATCH_2}")
+        if(address GREATER_EQUAL RAM_ORIGIN AND address LESS ram_end)
+            math(EXPR size "0x${CMAKE_MATCH_3}")
+            math(EXPR total "${total} + ${size}")
+            set(section_${output_section} ${size})
+            list(APPEND output_sections ${output_section})
+        endif()
+        continue()
+    endif()
+
+    # Input section: one leading space, name, address, size, file
+    if(NOT line MATCHES "^ ([._A-Za-z][^ ]*) +0x([0-9a-fA-F]+) +0x([0-9a-fA-F]+) +(.+)$")
+        continue()
+    endif()
+    set(name "${CMAKE_MATCH_1}")
+    set(address_hex "${CMAKE_MATCH_2}")
+    set(size_hex "${CMAKE_MATCH_3}")
+    set(file "${CMAKE_MATCH_4}")
+
+    math(EXPR address "0x${address_hex}")
+    math(EXPR size "0x${size_hex}")
+    if(size EQUAL 0 OR address LESS RAM_ORIGIN OR address GREATER_EQUAL ram_end)
+        continue()
+    endif()
+
+    get_filename_component(file "${file}" NAME)
+    string(REGEX REPLACE "\\.(c|cpp|s)\\.obj$" ".\\1" file "${file}")
+    if(name MATCHES "^\\.(t?bss|t?data|RamFunc)\\.(.+)$")
+        set(object "${CMAKE_MATCH_2}")
+    else()
+        set(object "(${name})")
+    endif()
+    list(APPEND rows "${size}|${output_section}|${object}|${file}")
+endforeach()
+
+# The heap and stack reservation is a location counter move, not an input section
+if(DEFINED section_._user_heap_stack)
+    list(APPEND rows "${section_._user_heap_stack}|._user_heap_stack|(heap + main stack)|STM32F103XX_FLASH.ld")
+endif()
+
+list(SORT rows COMPARE NATURAL ORDER DESCENDING)
+
+function(pad_left value width out)
+    string(LENGTH "${value}" length)
+    while(length LESS width)
+        string(PREPEND value " ")
+        math(EXPR length "${length} + 1")
+    endwhile()
+    set(${out} "${value}" PARENT_SCOPE)
+endfunction()
+
+function(pad_right value width out)
+    string(LENGTH "${value}" length)
+    while(length LESS width)
+        string(APPEND value " ")
+        math(EXPR length "${length} + 1")
+    endwhile()
+    set(${out} "${value}" PARENT_SCOPE)
+endfunction()
+
+get_filename_component(map_name "${MAP_FILE}" NAME)
+set(report "RAM usage by object, from ${map_name}\n\n")
+string(APPEND report "   bytes  section             object                            file\n")
+foreach(row IN LISTS rows)
+    string(REPLACE "|" ";" fields "${row}")
+    list(GET fields 0 size)
+    list(GET fields 1 section)
+    list(GET fields 2 object)
+    list(GET fields 3 file)
+    pad_left("${size}" 8 size)
+    pad_right("${section}" 18 section)
+    pad_right("${object}" 32 object)
+    string(APPEND report "${size}  ${section}  ${object}  ${file}\n")
+endforeach()
+
+string(APPEND report "\n")
+list(REMOVE_DUPLICATES output_sections)
+foreach(section IN LISTS output_sections)
+    pad_left("${section_${section}}" 8 size)
+    string(APPEND report "${size}  ${section}\n")
+endforeach()
+math(EXPR percent "${total} * 100 / ${RAM_LENGTH}")
+pad_left("${total}" 8 size)
+string(APPEND report "${size}  total of ${RAM_LENGTH} (${percent}%)\n")
+
+file(WRITE "${OUTPUT_FILE}" "${report}")
+message(STATUS "RAM: ${total} of ${RAM_LENGTH} bytes (${percent}%), per object in ${OUTPUT_FILE}")